@@ -0,0 +1,194 @@
+#include "fms.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+namespace {
+const double DEG_TO_RAD = 3.14159265358979323846 / 180.0;
+const double EARTH_RADIUS_KM = 6371.0;
+}
+
+bool AirportGraph::setAirportCoordinates(AirportCode name, double lat, double lon) {
+    auto it = airportIndex.find(name);
+    if (it == airportIndex.end() || !isfinite(lat) || !isfinite(lon)) return false;
+    int i = it->second;
+    if (std::isnan(latitude[i])) coordinateCount++;
+    latitude[i] = lat * DEG_TO_RAD;
+    longitude[i] = lon * DEG_TO_RAD;
+    heuristicDirty = true;
+    return true;
+}
+
+bool AirportGraph::hasAllCoordinates() const {
+    return coordinateCount == airportCount();
+}
+
+double AirportGraph::greatCircle(int a, int b) const {
+    double dLat = latitude[b] - latitude[a];
+    double dLon = longitude[b] - longitude[a];
+    double h = sin(dLat / 2) * sin(dLat / 2)
+             + cos(latitude[a]) * cos(latitude[b]) * sin(dLon / 2) * sin(dLon / 2);
+    return 2 * EARTH_RADIUS_KM * asin(min(1.0, sqrt(h)));
+}
+
+// The largest factor k with k * greatCircle(u, v) <= weight(u, v) on every
+// route. k * greatCircle(x, target) is then a consistent A* potential by the
+// triangle inequality, and flooring it to an integer keeps it consistent.
+double AirportGraph::scaleForHeuristic() {
+    if (!heuristicDirty) return heuristicScale;
+    double scale = numeric_limits<double>::infinity();
+    for (const auto& entry : routes) {
+        const Route& r = entry.second;
+        double gc = greatCircle(r.u, r.v);
+        if (gc > 0) scale = min(scale, adj[r.u][r.posU].weight / gc);
+    }
+    heuristicScale = isfinite(scale) ? max(0.0, scale * (1 - 1e-9)) : 0.0;
+    heuristicDirty = false;
+    return heuristicScale;
+}
+
+int AirportGraph::searchOneSided(const CsrGraph& g, int s, int t, bool stopAtTarget, bool goalDirected,
+                                 DijkstraContext& ctx, int& settled) const {
+    int n = g.nodeCount();
+    SearchLabels& labels = ctx.labels[0];
+    RadixHeap& pq = ctx.heap[0];
+    labels.reset(n);
+    pq.clear();
+    if (goalDirected) ctx.potential.reset(n);
+    auto h = [&](int v) {
+        if (!goalDirected) return 0;
+        int p = ctx.potential.dist(v);
+        if (p == INT_MAX) {
+            p = static_cast<int>(floor(heuristicScale * greatCircle(v, t)));
+            ctx.potential.set(v, p, -1);
+        }
+        return p;
+    };
+
+    labels.set(s, 0, -1);
+    pq.push(h(s), s);
+    while (!pq.empty()) {
+        auto [f, u] = pq.top(); pq.pop();
+        int d = labels.dist(u);
+        if (f - h(u) != d) continue;
+        settled++;
+        if (stopAtTarget && u == t) break;
+        for (int e = g.begin(u); e < g.end(u); ++e) {
+            int v = g.targets[e], nd = d + g.weights[e];
+            if (nd < labels.dist(v)) {
+                labels.set(v, nd, u);
+                pq.push(nd + h(v), v);
+            }
+        }
+    }
+    return labels.dist(t);
+}
+
+// Alternates between a forward search from s and a backward search from t
+// (the graph is undirected), always expanding the side with the smaller
+// frontier key. Once the two keys sum to at least the best s-t distance seen
+// through a node reached by both, no shorter path can remain.
+int AirportGraph::searchBidirectional(const CsrGraph& g, int s, int t, DijkstraContext& ctx,
+                                      std::vector<int>& path, int& settled) const {
+    int n = g.nodeCount();
+    SearchLabels* labels = ctx.labels;
+    RadixHeap* pq = ctx.heap;
+    for (int side = 0; side < 2; ++side) {
+        labels[side].reset(n);
+        pq[side].clear();
+    }
+    labels[0].set(s, 0, -1);
+    labels[1].set(t, 0, -1);
+    pq[0].push(0, s);
+    pq[1].push(0, t);
+    long long best = LLONG_MAX;
+    int meet = -1;
+
+    while (!pq[0].empty() && !pq[1].empty()) {
+        if (static_cast<long long>(pq[0].top().first) + pq[1].top().first >= best) break;
+        int side = pq[0].top().first <= pq[1].top().first ? 0 : 1;
+        auto [d, u] = pq[side].top(); pq[side].pop();
+        if (d != labels[side].dist(u)) continue;
+        settled++;
+        const SearchLabels& other = labels[1 - side];
+        for (int e = g.begin(u); e < g.end(u); ++e) {
+            int v = g.targets[e], nd = d + g.weights[e];
+            if (nd >= labels[side].dist(v)) continue;
+            labels[side].set(v, nd, u);
+            pq[side].push(nd, v);
+            int ov = other.dist(v);
+            if (ov != INT_MAX && static_cast<long long>(nd) + ov < best) {
+                best = static_cast<long long>(nd) + ov;
+                meet = v;
+            }
+        }
+    }
+
+    path.clear();
+    if (meet < 0) return INT_MAX;
+    for (int cur = meet; cur != -1; cur = labels[0].parent(cur)) path.push_back(cur);
+    reverse(path.begin(), path.end());
+    for (int cur = labels[1].parent(meet); cur != -1; cur = labels[1].parent(cur)) path.push_back(cur);
+    return best > INT_MAX ? INT_MAX : static_cast<int>(best);
+}
+
+void AirportGraph::buildHierarchy() {
+    hierarchy.build(snapshot());
+    hierarchyVersion = graphVersion;
+}
+
+void AirportGraph::prepareQueries() {
+    snapshot();
+    if (hasAllCoordinates()) scaleForHeuristic();
+}
+
+std::pair<int, std::vector<AirportCode>> AirportGraph::shortestPath(AirportCode source, AirportCode dest,
+                                                                    RouteMode mode, RouteStats* stats) {
+    prepareQueries();
+    return findRoute(source, dest, mode, stats);
+}
+
+std::pair<int, std::vector<AirportCode>> AirportGraph::findRoute(AirportCode source, AirportCode dest,
+                                                                 RouteMode mode, RouteStats* stats) const {
+    if (mode == ROUTE_CONTRACTED && !hierarchyCurrent()) mode = ROUTE_AUTO;
+    if (mode == ROUTE_AUTO || (mode == ROUTE_ASTAR && !hasAllCoordinates())) {
+        mode = hasAllCoordinates() && mode == ROUTE_AUTO ? ROUTE_ASTAR : ROUTE_BIDIRECTIONAL;
+    }
+    int settled = 0;
+    if (stats) *stats = RouteStats{mode, 0};
+    auto a = airportIndex.find(source), b = airportIndex.find(dest);
+    if (a == airportIndex.end() || b == airportIndex.end()) return {INT_MAX, {}};
+    int s = a->second, t = b->second;
+    const CsrGraph& g = csr;
+    DijkstraContext& ctx = DijkstraContext::local();
+
+    int dist;
+    vector<int>& pathIdx = ctx.path;
+    pathIdx.clear();
+    if (mode == ROUTE_CONTRACTED) {
+        dist = hierarchy.query(s, t, pathIdx, &settled);
+    } else if (mode == ROUTE_BIDIRECTIONAL) {
+        if (s == t) {
+            dist = 0;
+            pathIdx.push_back(s);
+        } else {
+            dist = searchBidirectional(g, s, t, ctx, pathIdx, settled);
+        }
+    } else {
+        dist = searchOneSided(g, s, t, mode != ROUTE_FULL, mode == ROUTE_ASTAR, ctx, settled);
+        if (dist != INT_MAX) {
+            for (int cur = t; cur != -1; cur = ctx.labels[0].parent(cur)) pathIdx.push_back(cur);
+            reverse(pathIdx.begin(), pathIdx.end());
+        }
+    }
+    if (stats) stats->settled = settled;
+    if (dist == INT_MAX) return {INT_MAX, {}};
+
+    vector<AirportCode> pathNames;
+    pathNames.reserve(pathIdx.size());
+    for (int idx : pathIdx) pathNames.push_back(indexToAirport[idx]);
+    return {dist, std::move(pathNames)};
+}
@@ -0,0 +1,64 @@
+#include "fms.h"
+#include "bench_graphs.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// All-pairs distance matrix on the geographic network from bench_graphs.h:
+// full computation time per thread count, then an incremental refresh after
+// a handful of new routes, checked against a full recomputation.
+// Usage: bench_all_pairs [airports] [linksPerAirport] [changedRoutes]
+
+int main(int argc, char** argv) {
+    int airports = static_cast<int>(argOr(argc, argv, 1, 3000));
+    int links = static_cast<int>(argOr(argc, argv, 2, 6));
+    int changes = static_cast<int>(argOr(argc, argv, 3, 4));
+
+    AirportGraph graph;
+    vector<AirportCode> codes;
+    buildGeographicNetwork(graph, airports, links, 42, codes);
+    cout << "airports=" << airports << "  routes=" << graph.routeCount()
+         << "  hardware threads=" << thread::hardware_concurrency() << "\n";
+
+    double single = 0;
+    for (int threads : {1, 2, 4, 8}) {
+        Stopwatch sw;
+        graph.computeAllPairs(threads);
+        double s = sw.seconds();
+        if (threads == 1) single = s;
+        cout << "full     threads=" << threads << "  s=" << s << "  speedup=" << single / s << "\n";
+    }
+    const DistanceMatrix& m = graph.allPairs();
+    cout << "matrix MiB=" << m.memoryBytes() / (1024.0 * 1024.0) << "  row stride=" << m.stride() << "\n";
+
+    // New routes between random airports a few hops apart, priced slightly
+    // under the current shortest distance so that they actually shortcut it.
+    mt19937 rng(7);
+    for (int c = 0; c < changes; ++c) {
+        int a = static_cast<int>(rng() % airports), target = static_cast<int>(rng() % airports), b = a;
+        for (int hop = 0; hop < 3 && m.nextHop(b, target) != -1; ++hop) b = m.nextHop(b, target);
+        if (b == a || m.distance(a, b) == DistanceMatrix::UNREACHABLE) continue;
+        graph.addEdge(codes[a], codes[b], max(1, m.distance(a, b) * 9 / 10));
+    }
+    Stopwatch sw;
+    int rows = graph.refreshAllPairs();
+    double refresh = sw.seconds();
+
+    int n = m.size();
+    vector<int32_t> refreshed(static_cast<size_t>(n) * n);
+    for (int i = 0; i < n; ++i) memcpy(&refreshed[static_cast<size_t>(i) * n], m.distanceRow(i), n * sizeof(int32_t));
+    sw.reset();
+    graph.computeAllPairs();
+    double full = sw.seconds();
+    long mismatches = 0;
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j) mismatches += refreshed[static_cast<size_t>(i) * n + j] != m.distance(i, j);
+    cout << "refresh  rows=" << rows << "/" << n << "  s=" << refresh << "  (full s=" << full << ")"
+         << (mismatches ? "  MISMATCHES=" + to_string(mismatches) : "") << "\n";
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include "fms.h"
+#include "bench_common.h"
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// End-to-end booking throughput with 1..32 producer threads calling
+// queueBooking while the booking worker confirms them.
+// Usage: bench_booking_queue [bookings] [flights]
+int main(int argc, char** argv) {
+    long total = argOr(argc, argv, 1, 2000000);
+    int flightCount = static_cast<int>(argOr(argc, argv, 2, 10000));
+
+    vector<string> ids;
+    for (int i = 0; i < flightCount; ++i) ids.push_back(makeFlightId(i));
+
+    for (int producers : {1, 2, 4, 8, 16, 32}) {
+        FlightSystem fs;
+        for (int i = 0; i < flightCount; ++i) {
+            fs.addFlightParams(ids[i], "A" + to_string(i % 50), "B" + to_string(i % 70), 100, 1 << 30);
+        }
+        long perThread = total / producers;
+        fs.startBookingWorker();
+        Stopwatch sw;
+        vector<thread> threads;
+        vector<long> fullRetries(producers, 0);
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&, p]() {
+                string name = "Passenger" + to_string(p);
+                for (long i = 0; i < perThread; ++i) {
+                    const string& id = ids[(i * 31 + p) % flightCount];
+                    while (!fs.queueBooking(id, name)) {
+                        fullRetries[p]++;
+                        this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (thread& t : threads) t.join();
+        double produced = sw.seconds();
+        fs.stopBookingWorker();
+        double drained = sw.seconds();
+
+        long confirmed = 0, retries = 0;
+        for (const Flight& f : fs.listFlights()) confirmed += (1 << 30) - f.seats.load();
+        for (long r : fullRetries) retries += r;
+        long n = perThread * producers;
+        cout << "producers=" << producers
+             << "  enqueue/s=" << static_cast<long>(n / produced)
+             << "  confirmed/s=" << static_cast<long>(confirmed / drained)
+             << "  confirmed=" << confirmed << "/" << n
+             << "  full-queue retries=" << retries << "\n";
+    }
+    return 0;
+}
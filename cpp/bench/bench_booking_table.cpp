@@ -0,0 +1,121 @@
+#include "fms.h"
+#include "bench_common.h"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+// Books N passengers across a set of flights, then runs a cancellation storm
+// (cancel a random 20% of bookings by ID) and a full iteration over every
+// flight's bookings. Runs once with per-flight BookingNode lists (the previous
+// layout) and once with BookingTable, each in a forked child so allocation
+// counts and peak RSS are reported per mode.
+// Usage: bench_booking_table [bookings] [flights]
+
+static atomic<long> allocCount(0);
+
+void* operator new(size_t size) {
+    allocCount.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(size)) return p;
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static void runList(long n, int flightCount, const vector<int>& victims) {
+    vector<BookingNode*> heads(flightCount, nullptr);
+    long allocs = allocCount.load();
+    Stopwatch sw;
+    for (long i = 0; i < n; ++i) {
+        int f = static_cast<int>(i % flightCount);
+        BookingNode* node = new BookingNode(static_cast<int>(i + 1), "Passenger" + to_string(i % 100000));
+        node->next = heads[f];
+        heads[f] = node;
+    }
+    double book = sw.seconds();
+    sw.reset();
+    long cancelled = 0;
+    for (int id : victims) {
+        int f = (id - 1) % flightCount;
+        BookingNode* cur = heads[f];
+        BookingNode* prev = nullptr;
+        while (cur && cur->bookingId != id) {
+            prev = cur;
+            cur = cur->next;
+        }
+        if (!cur) continue;
+        if (prev) prev->next = cur->next;
+        else heads[f] = cur->next;
+        delete cur;
+        cancelled++;
+    }
+    double cancel = sw.seconds();
+    sw.reset();
+    long sum = 0;
+    for (BookingNode* head : heads) {
+        for (BookingNode* cur = head; cur; cur = cur->next) sum += cur->bookingId;
+    }
+    double scan = sw.seconds();
+    cout << "list   book/s=" << static_cast<long>(n / book)
+         << "  cancel/s=" << static_cast<long>(victims.size() / cancel)
+         << "  scan(s)=" << scan
+         << "  operator-new calls=" << allocCount.load() - allocs
+         << "  peak RSS(MB)=" << peakRssBytes() / (1024.0 * 1024.0)
+         << "  cancelled=" << cancelled << " sum=" << sum << "\n";
+}
+
+static void runTable(long n, int flightCount, const vector<int>& victims) {
+    BookingTable table;
+    long allocs = allocCount.load();
+    Stopwatch sw;
+    for (long i = 0; i < n; ++i) {
+        table.add(static_cast<int>(i % flightCount), "Passenger" + to_string(i % 100000));
+    }
+    double book = sw.seconds();
+    sw.reset();
+    long cancelled = 0;
+    for (int id : victims) cancelled += table.cancel((id - 1) % flightCount, id);
+    double cancel = sw.seconds();
+    sw.reset();
+    long sum = 0;
+    for (int f = 0; f < flightCount; ++f) {
+        table.forEach(f, [&sum](const BookingRecord& r) { sum += r.bookingId; });
+    }
+    double scan = sw.seconds();
+    cout << "table  book/s=" << static_cast<long>(n / book)
+         << "  cancel/s=" << static_cast<long>(victims.size() / cancel)
+         << "  scan(s)=" << scan
+         << "  operator-new calls=" << allocCount.load() - allocs
+         << "  peak RSS(MB)=" << peakRssBytes() / (1024.0 * 1024.0)
+         << "  cancelled=" << cancelled << " sum=" << sum << "\n";
+}
+
+int main(int argc, char** argv) {
+    long n = argOr(argc, argv, 1, 5000000);
+    int flights = static_cast<int>(argOr(argc, argv, 2, 10000));
+    mt19937 rng(11);
+    vector<int> victims;
+    for (long i = 0; i < n / 5; ++i) victims.push_back(static_cast<int>(rng() % n) + 1);
+
+    for (int mode = 0; mode < 2; ++mode) {
+        cout.flush();
+        pid_t pid = fork();
+        if (pid == 0) {
+            if (mode == 0) runList(n, flights, victims);
+            else runTable(n, flights, victims);
+            cout.flush();
+            _exit(0);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sys/resource.h>
+#include "codes.h"
+
+// Small helpers shared by the benchmark programs. Each benchmark is a plain
+// executable that prints one line per measurement; sizes can be overridden on
+// the command line. The check_* programs alongside them are run by ctest and
+// exit nonzero if any expectation failed.
+
+class Stopwatch {
+public:
+    Stopwatch() : start(std::chrono::steady_clock::now()) {}
+    void reset() { start = std::chrono::steady_clock::now(); }
+    double seconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+private:
+    std::chrono::steady_clock::time_point start;
+};
+
+// Resident set size in bytes, read from /proc where available and falling
+// back to the peak RSS reported by getrusage.
+inline size_t peakRssBytes() {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+#ifdef __APPLE__
+    return static_cast<size_t>(ru.ru_maxrss);
+#else
+    return static_cast<size_t>(ru.ru_maxrss) * 1024;
+#endif
+}
+
+inline size_t currentRssBytes() {
+#ifdef __linux__
+    if (FILE* f = std::fopen("/proc/self/statm", "r")) {
+        long pages = 0, resident = 0;
+        int got = std::fscanf(f, "%ld %ld", &pages, &resident);
+        std::fclose(f);
+        if (got == 2) return static_cast<size_t>(resident) * 4096;
+    }
+#endif
+    return peakRssBytes();
+}
+
+inline long argOr(int argc, char** argv, int i, long fallback) {
+    return argc > i ? std::atol(argv[i]) : fallback;
+}
+
+inline std::string makeFlightId(long i) {
+    return "F" + std::to_string(100 + i);
+}
+
+inline FlightCode makeFlightCode(long i) {
+    FlightCode code;
+    FlightCode::parse(makeFlightId(i), code);
+    return code;
+}
+
+inline AirportCode makeAirportCode(const std::string& name) {
+    AirportCode code;
+    AirportCode::parse(name, code);
+    return code;
+}
+
+// Prints a line for a failed expectation and counts it; check programs
+// return checkFailures() != 0 from main.
+inline int& checkFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+inline void expect(bool ok, const std::string& what) {
+    if (ok) return;
+    std::printf("FAILED: %s\n", what.c_str());
+    checkFailures()++;
+}
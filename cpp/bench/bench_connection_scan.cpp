@@ -0,0 +1,79 @@
+#include "fms.h"
+#include "bench_graphs.h"
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Earliest-arrival queries with the Connection Scan Algorithm on a generated
+// one-week schedule: each airport serves a fixed set of routes, busier
+// airports get more departures, and every route has its own block time.
+// Reports timetable build time and memory, then query latency percentiles.
+// Usage: bench_connection_scan [airports] [flightsPerDay] [queries]
+
+int main(int argc, char** argv) {
+    int airports = static_cast<int>(argOr(argc, argv, 1, 1000));
+    long perDay = argOr(argc, argv, 2, 100000);
+    int queries = static_cast<int>(argOr(argc, argv, 3, 2000));
+    const int ROUTES_PER_AIRPORT = 12;
+    const int64_t WEEK = 7 * 24 * 3600, START = 1704067200;  // 2024-01-01
+
+    mt19937 rng(42);
+    vector<AirportCode> codes(airports);
+    vector<vector<int>> routes(airports);
+    for (int i = 0; i < airports; ++i) {
+        codes[i] = makeAirportCode("AP" + to_string(i));
+        for (int r = 0; r < ROUTES_PER_AIRPORT; ++r) {
+            // Skewed towards low indices, which act as hubs.
+            double u = uniform_real_distribution<double>(0, 1)(rng);
+            int dest = static_cast<int>(u * u * airports);
+            if (dest != i) routes[i].push_back(dest);
+        }
+    }
+    FlightStore store;
+    long total = perDay * 7;
+    uniform_int_distribution<int64_t> departure(START, START + WEEK - 1);
+    for (long k = 0; k < total; ++k) {
+        double u = uniform_real_distribution<double>(0, 1)(rng);
+        int from = static_cast<int>(u * u * airports);
+        if (routes[from].empty()) continue;
+        int to = routes[from][rng() % routes[from].size()];
+        Flight& f = store.append();
+        f.flightID = makeFlightCode(k);
+        f.source = codes[from];
+        f.destination = codes[to];
+        f.departureTime = departure(rng) / 300 * 300;
+        f.arrivalTime = f.departureTime + 2700 + ((from * 7919 + to * 104729) % 28800);  // 45 min to 8h45
+    }
+
+    ConnectionScan scan;
+    scan.setDefaultConnectionTime(45 * 60);
+    Stopwatch sw;
+    scan.build(store);
+    double build = sw.seconds();
+    cout << "airports=" << airports << "  connections=" << scan.connectionCount()
+         << "  build s=" << build << "  timetable MiB=" << scan.memoryBytes() / (1024.0 * 1024.0) << "\n";
+
+    // Leave within the first three days so most journeys fit in the week.
+    uniform_int_distribution<int64_t> startTime(START, START + 3 * 24 * 3600);
+    vector<double> micros;
+    long reached = 0, legs = 0;
+    scan.earliestArrival(codes[0], codes[1], START);  // warm up the thread's labels
+    for (int q = 0; q < queries; ++q) {
+        AirportCode s = codes[rng() % airports], t = codes[rng() % airports];
+        int64_t after = startTime(rng);
+        Stopwatch qsw;
+        Journey j = scan.earliestArrival(s, t, after);
+        micros.push_back(qsw.seconds() * 1e6);
+        if (j.arrival >= 0) {
+            reached++;
+            legs += static_cast<long>(j.flights.size());
+        }
+    }
+    cout << "earliest arrival  reached=" << reached << "/" << queries
+         << "  legs/journey=" << (reached ? static_cast<double>(legs) / reached : 0)
+         << "  p50 us=" << percentile(micros, 0.5) << "  p99 us=" << percentile(micros, 0.99) << "\n";
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include "fms.h"
+#include "bench_graphs.h"
+#include <climits>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Contraction Hierarchies on the geographic network from bench_graphs.h:
+// preprocessing time, shortcut count and index memory, then query latency
+// against bidirectional Dijkstra and A* on the same pairs.
+// Usage: bench_contraction_hierarchy [airports] [linksPerAirport] [queries]
+
+int main(int argc, char** argv) {
+    int airports = static_cast<int>(argOr(argc, argv, 1, 10000));
+    int links = static_cast<int>(argOr(argc, argv, 2, 6));
+    int queries = static_cast<int>(argOr(argc, argv, 3, 2000));
+
+    AirportGraph graph;
+    vector<AirportCode> codes;
+    buildGeographicNetwork(graph, airports, links, 42, codes);
+    const CsrGraph& g = graph.snapshot();
+
+    Stopwatch sw;
+    graph.buildHierarchy();
+    double build = sw.seconds();
+    const ContractionHierarchy& ch = graph.contractionHierarchy();
+    size_t graphBytes = (g.offsets.capacity() + g.targets.capacity() + g.weights.capacity()) * sizeof(int);
+    cout << "airports=" << airports << "  routes=" << graph.routeCount() << "\n"
+         << "preprocess (s)=" << build << "  shortcuts=" << ch.shortcutCount()
+         << "  index KiB=" << ch.memoryBytes() / 1024 << "  (csr graph KiB=" << graphBytes / 1024 << ")\n";
+
+    mt19937 rng(7);
+    vector<pair<int, int>> pairs;
+    for (int q = 0; q < queries; ++q) pairs.push_back({static_cast<int>(rng() % airports), static_cast<int>(rng() % airports)});
+
+    const RouteMode modes[] = {ROUTE_BIDIRECTIONAL, ROUTE_ASTAR, ROUTE_CONTRACTED};
+    const char* names[] = {"bidirectional", "astar        ", "contracted   "};
+    vector<int> reference;
+    for (int m = 0; m < 3; ++m) {
+        vector<double> micros;
+        long settled = 0;
+        int mismatches = 0;
+        for (int q = 0; q < queries; ++q) {
+            RouteStats stats;
+            Stopwatch qsw;
+            int d = graph.shortestPath(codes[pairs[q].first], codes[pairs[q].second], modes[m], &stats).first;
+            micros.push_back(qsw.seconds() * 1e6);
+            settled += stats.settled;
+            if (m == 0) reference.push_back(d);
+            else if (d != reference[q]) mismatches++;
+        }
+        cout << names[m] << "  settled/query=" << settled / queries
+             << "  p50 us=" << percentile(micros, 0.5)
+             << "  p99 us=" << percentile(micros, 0.99)
+             << (mismatches ? "  MISMATCHES=" + to_string(mismatches) : "") << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include "fms.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+using namespace std;
+
+// Loads a flights file of N rows between A airports, one row in a thousand
+// malformed, with loadFlightsCsv and with the row-at-a-time path (getline,
+// split, addFlightParams) that callers used before, reporting rows/s for
+// each. The two systems are compared on a few routes afterwards.
+// Usage: bench_csv_load [rows] [airports] [threads] [path]
+
+int main(int argc, char** argv) {
+    long n = argOr(argc, argv, 1, 10000000);
+    int airports = static_cast<int>(argOr(argc, argv, 2, 2000));
+    int threads = static_cast<int>(argOr(argc, argv, 3, 0));
+    string path = argc > 4 ? argv[4] : "bench_csv_load.csv";
+
+    mt19937 rng(42);
+    Stopwatch sw;
+    {
+        ofstream out(path, ios::binary);
+        string line;
+        for (long i = 0; i < n; ++i) {
+            int a = static_cast<int>(rng() % airports), b = static_cast<int>(rng() % airports);
+            line = makeFlightId(i) + ",AP" + to_string(a) + ",AP" + to_string(b) + "," +
+                   to_string(100 + rng() % 5000) + "," + to_string(rng() % 300) + (rng() % 20 ? ",True\n" : ",False\n");
+            if (i % 1000 == 999) line = makeFlightId(i) + ",AP" + to_string(a) + ",oops\n";
+            out << line;
+        }
+    }
+    struct stat st;
+    stat(path.c_str(), &st);
+    cout << "rows=" << n << "  airports=" << airports << "  file MiB=" << st.st_size / (1024.0 * 1024.0)
+         << "  write s=" << sw.seconds() << "\n";
+
+    FlightSystem bulk;
+    size_t rssBefore = currentRssBytes();
+    sw.reset();
+    LoadReport report = bulk.loadFlightsCsv(path, threads);
+    double bulkSeconds = sw.seconds();
+    cout << "loadFlightsCsv   s=" << bulkSeconds << "  rows/s=" << static_cast<long>(n / bulkSeconds)
+         << "  loaded=" << report.loaded << "  rejected=" << report.rejected
+         << "  RSS MiB=" << (currentRssBytes() - rssBefore) / (1024.0 * 1024.0) << "\n";
+    if (!report.errors.empty()) {
+        cout << "first error       line " << report.errors[0].line << ": " << report.errors[0].reason << "\n";
+    }
+
+    FlightSystem rows;
+    sw.reset();
+    {
+        ifstream in(path);
+        string line, field[6];
+        while (getline(in, line)) {
+            stringstream ss(line);
+            int count = 0;
+            while (count < 6 && getline(ss, field[count], ',')) count++;
+            if (count != 6 || !ss.eof()) continue;
+            try {
+                if (rows.addFlightParams(field[0], field[1], field[2], stoi(field[3]), stoi(field[4]))
+                    && field[5] == "False") {
+                    rows.cancelFlightById(field[0]);
+                }
+            } catch (const exception&) {
+            }
+        }
+    }
+    double rowSeconds = sw.seconds();
+    cout << "addFlightParams  s=" << rowSeconds << "  rows/s=" << static_cast<long>(n / rowSeconds) << "\n";
+
+    long mismatches = 0;
+    for (int q = 0; q < 100; ++q) {
+        string a = "AP" + to_string(rng() % airports), b = "AP" + to_string(rng() % airports);
+        mismatches += bulk.dijkstraPath(a, b).first != rows.dijkstraPath(a, b).first;
+        mismatches += bulk.searchFlightsBySourceNonInteractive(a).size() != rows.searchFlightsBySourceNonInteractive(a).size();
+    }
+    if (mismatches) cout << "MISMATCHES=" << mismatches << "\n";
+    remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,131 @@
+#include "fms.h"
+#include "bench_graphs.h"
+#include <atomic>
+#include <climits>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Heap allocations and latency per point-to-point query: a search that
+// allocates its distance/parent arrays and std::priority_queue per call (as
+// dijkstra_path used to) against findRoute on a reused DijkstraContext, then
+// findRoute throughput with several threads querying at once.
+// Usage: bench_dijkstra_context [airports] [linksPerAirport] [queries]
+
+static atomic<long> allocations(0);
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static int allocatingDijkstra(const CsrGraph& g, int s, int t, vector<int>& path) {
+    using PII = pair<int, int>;
+    int n = g.nodeCount();
+    vector<int> dist(n, INT_MAX);
+    vector<int> parent(n, -1);
+    priority_queue<PII, vector<PII>, greater<PII>> pq;
+    dist[s] = 0;
+    pq.push({0, s});
+    while (!pq.empty()) {
+        auto [d, u] = pq.top(); pq.pop();
+        if (d != dist[u]) continue;
+        if (u == t) break;
+        for (int e = g.begin(u); e < g.end(u); ++e) {
+            int v = g.targets[e], nd = d + g.weights[e];
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                parent[v] = u;
+                pq.push({nd, v});
+            }
+        }
+    }
+    path.clear();
+    for (int cur = dist[t] == INT_MAX ? -1 : t; cur != -1; cur = parent[cur]) path.push_back(cur);
+    return dist[t];
+}
+
+int main(int argc, char** argv) {
+    int airports = static_cast<int>(argOr(argc, argv, 1, 10000));
+    int links = static_cast<int>(argOr(argc, argv, 2, 6));
+    int queries = static_cast<int>(argOr(argc, argv, 3, 1000));
+
+    AirportGraph graph;
+    vector<AirportCode> codes;
+    buildGeographicNetwork(graph, airports, links, 42, codes);
+    graph.buildHierarchy();
+    graph.prepareQueries();
+    const CsrGraph& g = graph.snapshot();
+    cout << "airports=" << airports << "  routes=" << graph.routeCount() << "\n";
+
+    mt19937 rng(7);
+    vector<pair<int, int>> pairs;
+    for (int q = 0; q < queries; ++q) pairs.push_back({static_cast<int>(rng() % airports), static_cast<int>(rng() % airports)});
+
+    auto report = [&](const char* name, const function<int(int)>& query, const vector<int>* reference) {
+        query(0);  // warm up the thread's context
+        vector<double> micros;
+        micros.reserve(queries);
+        int mismatches = 0;
+        long before = allocations.load();
+        for (int q = 0; q < queries; ++q) {
+            Stopwatch sw;
+            int d = query(q);
+            micros.push_back(sw.seconds() * 1e6);
+            if (reference && d != (*reference)[q]) mismatches++;
+        }
+        long allocs = allocations.load() - before;
+        cout << name << "  allocs/query=" << static_cast<double>(allocs) / queries
+             << "  p50 us=" << percentile(micros, 0.5) << "  p99 us=" << percentile(micros, 0.99)
+             << (mismatches ? "  MISMATCHES=" + to_string(mismatches) : "") << "\n";
+    };
+
+    vector<int> reference(queries);
+    vector<int> path;
+    for (int q = 0; q < queries; ++q) reference[q] = allocatingDijkstra(g, pairs[q].first, pairs[q].second, path);
+    report("allocating early exit", [&](int q) { return allocatingDijkstra(g, pairs[q].first, pairs[q].second, path); },
+           &reference);
+
+    const RouteMode modes[] = {ROUTE_EARLY_EXIT, ROUTE_BIDIRECTIONAL, ROUTE_ASTAR, ROUTE_CONTRACTED};
+    const char* names[] = {"context early exit   ", "context bidirectional", "context astar        ",
+                           "context contracted   "};
+    for (int m = 0; m < 4; ++m) {
+        report(names[m], [&](int q) {
+            return graph.findRoute(codes[pairs[q].first], codes[pairs[q].second], modes[m]).first;
+        }, &reference);
+    }
+    cout << "(findRoute allocates only its returned path; context KiB per thread="
+         << (DijkstraContext::local().labels[0].memoryBytes() * 3) / 1024 << ")\n";
+
+    for (int threads : {1, 2, 4}) {
+        atomic<int> next(0);
+        atomic<long> checksum(0);
+        Stopwatch sw;
+        vector<thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&]() {
+                long sum = 0;
+                for (int q; (q = next.fetch_add(1)) < queries;) {
+                    sum += graph.findRoute(codes[pairs[q].first], codes[pairs[q].second], ROUTE_ASTAR).first;
+                }
+                checksum += sum;
+            });
+        }
+        for (thread& w : workers) w.join();
+        cout << "concurrent astar threads=" << threads << "  queries/s=" << static_cast<long>(queries / sw.seconds())
+             << "  checksum=" << checksum.load() << "\n";
+    }
+    return 0;
+}
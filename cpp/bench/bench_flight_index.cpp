@@ -0,0 +1,82 @@
+#include "fms.h"
+#include "bench_common.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+// Compares the unbalanced FlightBST with the FlightIndex B+ tree on sequential
+// and shuffled flight IDs. Usage: bench_flight_index [maxBstSequential]
+//
+// Sequential IDs turn FlightBST into a linked list: inserts are O(n^2) and the
+// recursive insert/search go n frames deep, so sequential BST runs above
+// maxBstSequential (default 20000) are skipped rather than overflowing the stack.
+
+static void runOne(const char* order, long n, bool shuffled, long maxBstSequential) {
+    FlightStore store;
+    vector<Flight*> flights;
+    flights.reserve(n);
+    for (long i = 0; i < n; ++i) {
+        Flight& f = store.append();
+        f.flightID = makeFlightCode(i);
+        flights.push_back(&f);
+    }
+    if (shuffled) {
+        mt19937 rng(42);
+        shuffle(flights.begin(), flights.end(), rng);
+    }
+    vector<FlightCode> probes;
+    probes.reserve(n);
+    for (Flight* f : flights) probes.push_back(f->flightID);
+    mt19937 rng(7);
+    shuffle(probes.begin(), probes.end(), rng);
+
+    if (shuffled || n <= maxBstSequential) {
+        FlightBST bst;
+        Stopwatch sw;
+        for (Flight* f : flights) bst.insert(f);
+        double ins = sw.seconds();
+        sw.reset();
+        long hits = 0;
+        for (FlightCode id : probes) hits += bst.search(id) != nullptr;
+        double look = sw.seconds();
+        cout << "FlightBST    " << order << " n=" << n
+             << "  insert/s=" << static_cast<long>(n / ins)
+             << "  search/s=" << static_cast<long>(n / look)
+             << "  hits=" << hits << "\n";
+    } else {
+        cout << "FlightBST    " << order << " n=" << n << "  skipped (degenerate chain)\n";
+    }
+
+    FlightIndex index;
+    Stopwatch sw;
+    for (Flight* f : flights) index.insert(f);
+    double ins = sw.seconds();
+    sw.reset();
+    long hits = 0;
+    for (FlightCode id : probes) hits += index.search(id) != nullptr;
+    double look = sw.seconds();
+    cout << "FlightIndex  " << order << " n=" << n
+         << "  insert/s=" << static_cast<long>(n / ins)
+         << "  search/s=" << static_cast<long>(n / look)
+         << "  hits=" << hits << "  height=" << index.height() << "\n";
+
+    sw.reset();
+    FlightIndex bulk;
+    bulk.bulkBuild(flights);
+    double build = sw.seconds();
+    cout << "bulkBuild    " << order << " n=" << n
+         << "  build/s=" << static_cast<long>(n / build)
+         << "  height=" << bulk.height() << "\n";
+}
+
+int main(int argc, char** argv) {
+    long maxBstSequential = argOr(argc, argv, 1, 20000);
+    for (long n : {10000L, 100000L, 1000000L}) {
+        runOne("sequential", n, false, maxBstSequential);
+        runOne("random    ", n, true, maxBstSequential);
+    }
+    return 0;
+}
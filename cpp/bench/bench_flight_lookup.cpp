@@ -0,0 +1,74 @@
+#include "fms.h"
+#include "bench_common.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Flight-ID lookups per second through FlightIdMap and FlightIndex (packed
+// FlightCode keys) and a std::unordered_map<string,int> baseline, for hits
+// and misses.
+// Usage: bench_flight_lookup [flights] [lookups]
+int main(int argc, char** argv) {
+    long n = argOr(argc, argv, 1, 1000000);
+    long q = argOr(argc, argv, 2, 5000000);
+
+    FlightStore store;
+    FlightIdMap ids(store);
+    FlightIndex index;
+    unordered_map<string, int> baseline;
+    ids.reserve(static_cast<int>(n));
+    baseline.reserve(n);
+    for (long i = 0; i < n; ++i) {
+        Flight& f = store.append();
+        f.flightID = makeFlightCode(i);
+        ids.insert(static_cast<int>(i));
+        index.insert(&f);
+        baseline[makeFlightId(i)] = static_cast<int>(i);
+    }
+
+    mt19937 rng(3);
+    vector<string> hits, misses;
+    for (long i = 0; i < 100000; ++i) {
+        hits.push_back(makeFlightId(rng() % n));
+        misses.push_back("X" + to_string(rng() % n));
+    }
+    vector<FlightCode> hitCodes, missCodes;
+    FlightCode code;
+    for (const string& id : hits) {
+        FlightCode::parse(id, code);
+        hitCodes.push_back(code);
+    }
+    for (const string& id : misses) {
+        FlightCode::parse(id, code);
+        missCodes.push_back(code);
+    }
+
+    for (int pass = 0; pass < 2; ++pass) {
+        const vector<string>& probes = pass == 0 ? hits : misses;
+        const vector<FlightCode>& codes = pass == 0 ? hitCodes : missCodes;
+        const char* label = pass == 0 ? "hit " : "miss";
+        long found = 0;
+
+        Stopwatch sw;
+        for (long i = 0; i < q; ++i) found += ids.find(codes[i % codes.size()]) >= 0;
+        double tMap = sw.seconds();
+
+        sw.reset();
+        for (long i = 0; i < q; ++i) found += index.search(codes[i % codes.size()]) != nullptr;
+        double tIndex = sw.seconds();
+
+        sw.reset();
+        for (long i = 0; i < q; ++i) found += baseline.count(probes[i % probes.size()]);
+        double tStd = sw.seconds();
+
+        cout << label << "  FlightIdMap/s=" << static_cast<long>(q / tMap)
+             << "  FlightIndex/s=" << static_cast<long>(q / tIndex)
+             << "  unordered_map/s=" << static_cast<long>(q / tStd)
+             << "  found=" << found << "\n";
+    }
+    return 0;
+}
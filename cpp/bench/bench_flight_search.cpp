@@ -0,0 +1,90 @@
+#include "fms.h"
+#include "bench_common.h"
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Source and route queries through FlightSearchIndex against the linear scan
+// of every stored flight they replace. Usage: bench_flight_search [flights] [airports]
+
+int main(int argc, char** argv) {
+    long n = argOr(argc, argv, 1, 100000);
+    int airportCount = static_cast<int>(argOr(argc, argv, 2, 200));
+    const int queries = 20000;
+
+    vector<AirportCode> airports;
+    for (int i = 0; i < airportCount; ++i) airports.push_back(makeAirportCode("AP" + to_string(i)));
+
+    mt19937 rng(42);
+    uniform_int_distribution<int> pick(0, airportCount - 1);
+    FlightStore store;
+    FlightSearchIndex index;
+    Stopwatch sw;
+    for (long i = 0; i < n; ++i) {
+        Flight& f = store.append();
+        f.flightID = makeFlightCode(i);
+        f.source = airports[pick(rng)];
+        f.destination = airports[pick(rng)];
+        f.distance = 100 + static_cast<int>(i % 2000);
+        f.active = i % 10 != 0;
+        if (f.active) index.add(f, static_cast<int>(i));
+    }
+    double build = sw.seconds();
+    cout << "flights=" << n << "  airports=" << airportCount
+         << "  index build/s=" << static_cast<long>(n / build) << "\n";
+
+    vector<pair<AirportCode, AirportCode>> probes;
+    for (int q = 0; q < queries; ++q) probes.push_back({airports[pick(rng)], airports[pick(rng)]});
+
+    // The scans are slow, so they run one query in a hundred; the checksums
+    // compare the same subset.
+    const int scanQueries = queries / 100;
+    long scanSum = 0;
+    sw.reset();
+    for (int q = 0; q < scanQueries; ++q) {
+        for (int i = 0; i < store.size(); ++i) {
+            const Flight& f = store[i];
+            if (f.source == probes[q].first && f.active) scanSum += f.distance;
+        }
+    }
+    double scan = sw.seconds() / scanQueries;
+    cout << "source scan    queries/s=" << static_cast<long>(1 / scan) << "\n";
+
+    long indexSum = 0, subsetSum = 0;
+    sw.reset();
+    for (int q = 0; q < queries; ++q) {
+        if (q == scanQueries) subsetSum = indexSum;
+        for (int slot : index.bySource(probes[q].first)) indexSum += store[slot].distance;
+    }
+    double indexed = sw.seconds() / queries;
+    cout << "source index   queries/s=" << static_cast<long>(1 / indexed)
+         << "  speedup=" << scan / indexed << "x  checksum=" << indexSum
+         << (scanSum == subsetSum ? "" : "  MISMATCH") << "\n";
+
+    long routeScanHits = 0;
+    sw.reset();
+    for (int q = 0; q < scanQueries; ++q) {
+        for (int i = 0; i < store.size(); ++i) {
+            const Flight& f = store[i];
+            if (f.source == probes[q].first && f.destination == probes[q].second && f.active) routeScanHits++;
+        }
+    }
+    double routeScan = sw.seconds() / scanQueries;
+    cout << "route scan     queries/s=" << static_cast<long>(1 / routeScan) << "\n";
+
+    long routeHits = 0, routeSubset = 0;
+    sw.reset();
+    for (int q = 0; q < queries; ++q) {
+        size_t hits = index.byRoute(probes[q].first, probes[q].second).size();
+        routeHits += hits;
+        if (q < scanQueries) routeSubset += hits;
+    }
+    double routeIndexed = sw.seconds() / queries;
+    cout << "route index    queries/s=" << static_cast<long>(1 / routeIndexed)
+         << "  speedup=" << routeScan / routeIndexed << "x  hits=" << routeHits
+         << (routeSubset == routeScanHits ? "" : "  MISMATCH") << "\n";
+    return 0;
+}
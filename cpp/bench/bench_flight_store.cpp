@@ -0,0 +1,44 @@
+#include "fms.h"
+#include "bench_common.h"
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+// Loads N flights into FlightStore and reports insertion throughput and the
+// resident memory each flight costs. Usage: bench_flight_store [N]
+int main(int argc, char** argv) {
+    long n = argOr(argc, argv, 1, 1000000);
+    AirportCode airports[8];
+    const char* names[] = {"PNQ", "BOM", "DEL", "BLR", "GOI", "MAA", "CCU", "HYD"};
+    for (int i = 0; i < 8; ++i) airports[i] = makeAirportCode(names[i]);
+
+    vector<FlightCode> ids;
+    ids.reserve(n);
+    for (long i = 0; i < n; ++i) ids.push_back(makeFlightCode(i));
+
+    size_t rssBefore = currentRssBytes();
+    Stopwatch sw;
+    FlightStore store;
+    for (long i = 0; i < n; ++i) {
+        Flight& f = store.append();
+        f.flightID = ids[i];
+        f.source = airports[i % 8];
+        f.destination = airports[(i + 3) % 8];
+        f.distance = 100 + static_cast<int>(i % 2000);
+        f.seats = 180;
+    }
+    double secs = sw.seconds();
+    size_t rssAfter = currentRssBytes();
+
+    long checksum = 0;
+    for (long i = 0; i < n; i += 997) checksum += store[static_cast<int>(i)].distance;
+
+    cout << "flights:            " << n << "\n";
+    cout << "insert time (s):    " << secs << "\n";
+    cout << "inserts/sec:        " << static_cast<long>(n / secs) << "\n";
+    cout << "store bytes/flight: " << static_cast<double>(store.memoryBytes()) / n << "\n";
+    cout << "rss bytes/flight:   " << static_cast<double>(rssAfter - rssBefore) / n << "\n";
+    cout << "checksum:           " << checksum << "\n";
+    return 0;
+}
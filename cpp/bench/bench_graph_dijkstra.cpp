@@ -0,0 +1,120 @@
+#include "fms.h"
+#include "bench_common.h"
+#include <climits>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Full single-source Dijkstra on the vector-of-vectors adjacency that
+// AirportGraph used to traverse against the same search on its CSR snapshot.
+// Usage: bench_graph_dijkstra [airports] [routes] [queries]
+
+using PII = pair<int, int>;
+
+static long dijkstraAdjacency(const vector<vector<PII>>& adj, int s, vector<int>& dist) {
+    dist.assign(adj.size(), INT_MAX);
+    priority_queue<PII, vector<PII>, greater<PII>> pq;
+    dist[s] = 0;
+    pq.push({0, s});
+    long settled = 0;
+    while (!pq.empty()) {
+        auto [d, u] = pq.top(); pq.pop();
+        if (d != dist[u]) continue;
+        settled++;
+        for (auto &p : adj[u]) {
+            int v = p.first, w = p.second;
+            if (dist[u] + w < dist[v]) {
+                dist[v] = dist[u] + w;
+                pq.push({dist[v], v});
+            }
+        }
+    }
+    return settled;
+}
+
+static long dijkstraCsr(const CsrGraph& g, int s, vector<int>& dist) {
+    dist.assign(g.nodeCount(), INT_MAX);
+    priority_queue<PII, vector<PII>, greater<PII>> pq;
+    dist[s] = 0;
+    pq.push({0, s});
+    long settled = 0;
+    while (!pq.empty()) {
+        auto [d, u] = pq.top(); pq.pop();
+        if (d != dist[u]) continue;
+        settled++;
+        for (int e = g.begin(u); e < g.end(u); ++e) {
+            int v = g.targets[e], w = g.weights[e];
+            if (dist[u] + w < dist[v]) {
+                dist[v] = dist[u] + w;
+                pq.push({dist[v], v});
+            }
+        }
+    }
+    return settled;
+}
+
+int main(int argc, char** argv) {
+    int airports = static_cast<int>(argOr(argc, argv, 1, 10000));
+    long routes = argOr(argc, argv, 2, 1000000);
+    int queries = static_cast<int>(argOr(argc, argv, 3, 50));
+
+    vector<AirportCode> codes;
+    for (int i = 0; i < airports; ++i) codes.push_back(makeAirportCode("AP" + to_string(i)));
+
+    mt19937 rng(42);
+    uniform_int_distribution<int> pick(0, airports - 1);
+    uniform_int_distribution<int> distance(50, 5000);
+    AirportGraph graph;
+    vector<vector<PII>> adj(airports);
+    for (int i = 0; i < airports; ++i) graph.getAirportIndex(codes[i]);
+    for (long r = 0; r < routes; ++r) {
+        int u = pick(rng), v = pick(rng), w = distance(rng);
+        graph.addEdge(codes[u], codes[v], w);
+        adj[u].push_back({v, w});
+        adj[v].push_back({u, w});
+    }
+
+    Stopwatch sw;
+    const CsrGraph& g = graph.snapshot();
+    double build = sw.seconds();
+    cout << "airports=" << airports << "  routes=" << routes
+         << "  csr build (s)=" << build << "\n";
+
+    vector<int> sources;
+    for (int q = 0; q < queries; ++q) sources.push_back(pick(rng));
+    vector<int> dist;
+
+    long settled = 0, checksum = 0;
+    sw.reset();
+    for (int s : sources) {
+        settled += dijkstraAdjacency(adj, s, dist);
+        checksum += dist[(s + 1) % airports];
+    }
+    double nested = sw.seconds() / queries;
+    cout << "adjacency lists  ms/query=" << nested * 1e3 << "  settled=" << settled
+         << "  checksum=" << checksum << "\n";
+
+    long csrChecksum = 0;
+    settled = 0;
+    sw.reset();
+    for (int s : sources) {
+        settled += dijkstraCsr(g, s, dist);
+        csrChecksum += dist[(s + 1) % airports];
+    }
+    double packed = sw.seconds() / queries;
+    cout << "csr snapshot     ms/query=" << packed * 1e3 << "  settled=" << settled
+         << "  speedup=" << nested / packed << "x"
+         << (csrChecksum == checksum ? "" : "  MISMATCH") << "\n";
+
+    long pathChecksum = 0;
+    sw.reset();
+    for (int s : sources) pathChecksum += graph.dijkstra_path(codes[s], codes[(s + 1) % airports]).first;
+    cout << "dijkstra_path    ms/query=" << sw.seconds() / queries * 1e3
+         << (pathChecksum == checksum ? "" : "  MISMATCH") << "\n";
+    return 0;
+}
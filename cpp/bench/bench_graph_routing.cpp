@@ -0,0 +1,52 @@
+#include "fms.h"
+#include "bench_graphs.h"
+#include <climits>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Point-to-point queries with each RouteMode on the synthetic geographic
+// network from bench_graphs.h. Reports settled airports and latency percentiles.
+// Usage: bench_graph_routing [airports] [linksPerAirport] [queries]
+
+int main(int argc, char** argv) {
+    int airports = static_cast<int>(argOr(argc, argv, 1, 10000));
+    int links = static_cast<int>(argOr(argc, argv, 2, 6));
+    int queries = static_cast<int>(argOr(argc, argv, 3, 500));
+
+    AirportGraph graph;
+    vector<AirportCode> codes;
+    long routes = buildGeographicNetwork(graph, airports, links, 42, codes);
+    mt19937 rng(7);
+    graph.snapshot();
+    cout << "airports=" << airports << "  routes=" << graph.routeCount() << "  flights=" << routes << "\n";
+
+    vector<pair<int, int>> pairs;
+    for (int q = 0; q < queries; ++q) pairs.push_back({static_cast<int>(rng() % airports), static_cast<int>(rng() % airports)});
+
+    const RouteMode modes[] = {ROUTE_FULL, ROUTE_EARLY_EXIT, ROUTE_BIDIRECTIONAL, ROUTE_ASTAR};
+    const char* names[] = {"full         ", "early exit   ", "bidirectional", "astar        "};
+    vector<int> reference;
+    for (int m = 0; m < 4; ++m) {
+        vector<double> micros;
+        long settled = 0;
+        int mismatches = 0;
+        for (int q = 0; q < queries; ++q) {
+            RouteStats stats;
+            Stopwatch sw;
+            int d = graph.shortestPath(codes[pairs[q].first], codes[pairs[q].second], modes[m], &stats).first;
+            micros.push_back(sw.seconds() * 1e6);
+            settled += stats.settled;
+            if (m == 0) reference.push_back(d);
+            else if (d != reference[q]) mismatches++;
+        }
+        cout << names[m] << "  settled/query=" << settled / queries
+             << "  p50 us=" << percentile(micros, 0.5)
+             << "  p99 us=" << percentile(micros, 0.99)
+             << (mismatches ? "  MISMATCHES=" + to_string(mismatches) : "") << "\n";
+    }
+    return 0;
+}
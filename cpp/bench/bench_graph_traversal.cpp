@@ -0,0 +1,91 @@
+#include "fms.h"
+#include "bench_graphs.h"
+#include <iostream>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Whole-graph traversals: the printing DFS()/BFS() (into a discarding
+// stream) against depthFirst/breadthFirst into a reused buffer, and
+// top-down breadthFirst against the direction-optimizing reachableFrom, on a
+// random low-diameter network and on the geographic one from bench_graphs.h.
+// Finishes with a depth-first traversal of a chain far deeper than the old
+// recursive DFS could handle.
+// Usage: bench_graph_traversal [randomAirports] [routesPerAirport] [chainLength]
+
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+static void run(const char* name, AirportGraph& graph, const vector<AirportCode>& codes, int starts) {
+    mt19937 rng(7);
+    vector<int> order, depth;
+    graph.snapshot();
+    graph.breadthFirst(codes[0], order);  // size the buffers once
+    graph.reachableFrom(codes[0], depth);
+    double printing = 0, dfs = 0, bfs = 0, reach = 0;
+    long visited = 0;
+    NullBuffer null;
+    for (int i = 0; i < starts; ++i) {
+        AirportCode s = codes[rng() % codes.size()];
+        streambuf* old = cout.rdbuf(&null);
+        Stopwatch sw;
+        graph.BFS(s);
+        printing += sw.seconds();
+        cout.rdbuf(old);
+        sw.reset();
+        visited += graph.depthFirst(s, order);
+        dfs += sw.seconds();
+        sw.reset();
+        graph.breadthFirst(s, order);
+        bfs += sw.seconds();
+        sw.reset();
+        graph.reachableFrom(s, depth);
+        reach += sw.seconds();
+    }
+    cout << name << "  airports=" << graph.airportCount() << "  routes=" << graph.routeCount()
+         << "  visited/start=" << visited / starts << "\n"
+         << "  BFS() printing ms=" << printing * 1e3 / starts
+         << "  depthFirst ms=" << dfs * 1e3 / starts
+         << "  breadthFirst ms=" << bfs * 1e3 / starts
+         << "  reachableFrom ms=" << reach * 1e3 / starts << "\n";
+}
+
+int main(int argc, char** argv) {
+    int airports = static_cast<int>(argOr(argc, argv, 1, 200000));
+    int perAirport = static_cast<int>(argOr(argc, argv, 2, 8));
+    int chain = static_cast<int>(argOr(argc, argv, 3, 1000000));
+
+    {
+        AirportGraph graph;
+        vector<AirportCode> codes(airports);
+        for (int i = 0; i < airports; ++i) codes[i] = makeAirportCode("R" + to_string(i));
+        mt19937 rng(42);
+        for (int i = 0; i < airports; ++i) {
+            for (int k = 0; k < perAirport; ++k) graph.addEdge(codes[i], codes[rng() % airports], 1 + rng() % 1000);
+        }
+        run("random    ", graph, codes, 10);
+    }
+    {
+        AirportGraph graph;
+        vector<AirportCode> codes;
+        buildGeographicNetwork(graph, airports / 4, 6, 42, codes);
+        run("geographic", graph, codes, 10);
+    }
+    {
+        AirportGraph graph;
+        vector<AirportCode> codes(chain);
+        for (int i = 0; i < chain; ++i) codes[i] = makeAirportCode("C" + to_string(i));
+        for (int i = 0; i + 1 < chain; ++i) graph.addEdge(codes[i], codes[i + 1], 1);
+        vector<int> order;
+        Stopwatch sw;
+        int visited = graph.depthFirst(codes[0], order);
+        cout << "chain       depthFirst visited=" << visited << "  ms=" << sw.seconds() * 1e3 << "\n";
+    }
+    return 0;
+}
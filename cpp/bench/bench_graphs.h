@@ -0,0 +1,75 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include "bench_common.h"
+#include "fms.h"
+
+// Synthetic airport networks shared by the graph benchmarks.
+
+inline double greatCircleKm(double lat1, double lon1, double lat2, double lon2) {
+    const double r = 3.14159265358979323846 / 180.0;
+    double dLat = (lat2 - lat1) * r, dLon = (lon2 - lon1) * r;
+    double h = std::sin(dLat / 2) * std::sin(dLat / 2)
+             + std::cos(lat1 * r) * std::cos(lat2 * r) * std::sin(dLon / 2) * std::sin(dLon / 2);
+    return 2 * 6371.0 * std::asin(std::min(1.0, std::sqrt(h)));
+}
+
+// Airports scattered over the globe (with coordinates set), each linked to
+// its `links` nearest airports found in its own and the neighbouring
+// 10-degree cells, with route distances 5-25% longer than great-circle.
+// Returns the number of flights added; codes receives the airport codes in
+// index order.
+inline long buildGeographicNetwork(AirportGraph& graph, int airports, int links, unsigned seed,
+                                   std::vector<AirportCode>& codes) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> latDist(-60, 70), lonDist(-180, 180), stretch(1.05, 1.25);
+    std::vector<double> lat(airports), lon(airports);
+    std::vector<std::vector<int>> cells(36 * 18);
+    auto cellOf = [](double la, double lo) {
+        int row = std::min(17, static_cast<int>((la + 90) / 10));
+        int col = std::min(35, static_cast<int>((lo + 180) / 10));
+        return row * 36 + col;
+    };
+
+    codes.clear();
+    for (int i = 0; i < airports; ++i) {
+        codes.push_back(makeAirportCode("AP" + std::to_string(i)));
+        lat[i] = latDist(rng);
+        lon[i] = lonDist(rng);
+        graph.getAirportIndex(codes[i]);
+        graph.setAirportCoordinates(codes[i], lat[i], lon[i]);
+        cells[cellOf(lat[i], lon[i])].push_back(i);
+    }
+    long flights = 0;
+    std::vector<std::pair<double, int>> nearby;
+    for (int i = 0; i < airports; ++i) {
+        int row = cellOf(lat[i], lon[i]) / 36, col = cellOf(lat[i], lon[i]) % 36;
+        nearby.clear();
+        for (int dr = -1; dr <= 1; ++dr) {
+            int r = row + dr;
+            if (r < 0 || r > 17) continue;
+            for (int dc = -1; dc <= 1; ++dc) {
+                for (int j : cells[r * 36 + (col + dc + 36) % 36]) {
+                    if (j != i) nearby.push_back({greatCircleKm(lat[i], lon[i], lat[j], lon[j]), j});
+                }
+            }
+        }
+        size_t k = std::min(nearby.size(), static_cast<size_t>(links));
+        std::partial_sort(nearby.begin(), nearby.begin() + k, nearby.end());
+        for (size_t n = 0; n < k; ++n) {
+            int d = static_cast<int>(std::ceil(nearby[n].first * stretch(rng)));
+            graph.addEdge(codes[i], codes[nearby[n].second], d);
+            flights++;
+        }
+    }
+    return flights;
+}
+
+inline double percentile(std::vector<double> v, double p) {
+    std::sort(v.begin(), v.end());
+    return v[static_cast<size_t>(p * (v.size() - 1))];
+}
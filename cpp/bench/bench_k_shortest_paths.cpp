@@ -0,0 +1,55 @@
+#include "fms.h"
+#include "bench_graphs.h"
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// K shortest loopless routes (Yen's algorithm) on the geographic network from
+// bench_graphs.h: latency percentiles and routes found per query with no
+// constraints, with no more legs than the shortest route has, and with a few
+// airports excluded.
+// Usage: bench_k_shortest_paths [airports] [linksPerAirport] [k] [queries]
+
+int main(int argc, char** argv) {
+    int airports = static_cast<int>(argOr(argc, argv, 1, 5000));
+    int links = static_cast<int>(argOr(argc, argv, 2, 6));
+    int k = static_cast<int>(argOr(argc, argv, 3, 10));
+    int queries = static_cast<int>(argOr(argc, argv, 4, 200));
+
+    AirportGraph graph;
+    vector<AirportCode> codes;
+    buildGeographicNetwork(graph, airports, links, 42, codes);
+    graph.prepareQueries();
+    cout << "airports=" << airports << "  routes=" << graph.routeCount() << "  k=" << k << "\n";
+
+    mt19937 rng(7);
+    vector<pair<int, int>> pairs;
+    for (int q = 0; q < queries; ++q) pairs.push_back({static_cast<int>(rng() % airports), static_cast<int>(rng() % airports)});
+    vector<AirportCode> excluded;
+    for (int i = 0; i < 20; ++i) excluded.push_back(codes[rng() % airports]);
+
+    for (int variant = 0; variant < 3; ++variant) {
+        vector<double> millis;
+        long found = 0;
+        for (int q = 0; q < queries; ++q) {
+            AirportCode s = codes[pairs[q].first], t = codes[pairs[q].second];
+            int maxLegs = 0;
+            if (variant == 1) {
+                auto fewest = graph.kShortestPaths(s, t, 1);
+                if (fewest.empty()) continue;
+                maxLegs = static_cast<int>(fewest[0].airports.size()) - 1;
+            }
+            Stopwatch sw;
+            auto routes = graph.kShortestPaths(s, t, k, maxLegs, variant == 2 ? excluded : vector<AirportCode>());
+            millis.push_back(sw.seconds() * 1e3);
+            found += static_cast<long>(routes.size());
+        }
+        const char* names[] = {"unconstrained     ", "maxLegs=shortest  ", "20 airports banned"};
+        cout << names[variant] << "  routes/query=" << static_cast<double>(found) / millis.size()
+             << "  p50 ms=" << percentile(millis, 0.5) << "  p99 ms=" << percentile(millis, 0.99) << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include "fms.h"
+#include "bench_graphs.h"
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Minimum spanning forests: serial primTree once, then kruskalForest
+// (parallel edge sort, serial union-find) and boruvkaForest (every phase
+// parallel) for 1, 2, 4, ... threads up to maxThreads, on a random network
+// and on the geographic one from bench_graphs.h. Every run is checked
+// against the single-threaded Kruskal forest.
+// Usage: bench_mst [randomAirports] [routesPerAirport] [maxThreads]
+
+static void run(const char* name, AirportGraph& graph, AirportCode start, int maxThreads) {
+    graph.snapshot();
+    Stopwatch sw;
+    SpanningForest prim = graph.primTree(start);
+    double primSeconds = sw.seconds();
+    sw.reset();
+    SpanningForest reference = graph.kruskalForest(1);
+    double serial = sw.seconds();
+    cout << name << "  airports=" << graph.airportCount() << "  routes=" << graph.routeCount()
+         << "  forest edges=" << reference.edges.size() << "  weight=" << reference.weight << "\n"
+         << "  primTree ms=" << primSeconds * 1e3 << "  (tree edges=" << prim.edges.size() << ")\n";
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        sw.reset();
+        SpanningForest kruskal = graph.kruskalForest(threads);
+        double k = sw.seconds();
+        sw.reset();
+        SpanningForest boruvka = graph.boruvkaForest(threads);
+        double b = sw.seconds();
+        bool same = kruskal.weight == reference.weight && boruvka.weight == reference.weight
+                    && boruvka.edges.size() == reference.edges.size();
+        cout << "  threads=" << threads << "  kruskalForest ms=" << k * 1e3 << " (x" << serial / k << ")"
+             << "  boruvkaForest ms=" << b * 1e3 << " (x" << serial / b << ")" << (same ? "" : "  MISMATCH") << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    int airports = static_cast<int>(argOr(argc, argv, 1, 200000));
+    int perAirport = static_cast<int>(argOr(argc, argv, 2, 8));
+    int maxThreads = static_cast<int>(argOr(argc, argv, 3, max(1u, thread::hardware_concurrency())));
+    cout << "hardware threads=" << thread::hardware_concurrency() << "\n";
+
+    {
+        AirportGraph graph;
+        vector<AirportCode> codes(airports);
+        for (int i = 0; i < airports; ++i) codes[i] = makeAirportCode("R" + to_string(i));
+        mt19937 rng(42);
+        for (int i = 0; i < airports; ++i) {
+            for (int k = 0; k < perAirport; ++k) graph.addEdge(codes[i], codes[rng() % airports], 1 + rng() % 1000);
+        }
+        run("random    ", graph, codes[0], maxThreads);
+    }
+    {
+        AirportGraph graph;
+        vector<AirportCode> codes;
+        buildGeographicNetwork(graph, airports / 4, 6, 42, codes);
+        run("geographic", graph, codes[0], maxThreads);
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include "fms.h"
+#include "bench_common.h"
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Seat reservation under contention. Usage: bench_seat_inventory [threads] [flights]
+//
+// contention: every thread reserves single seats on one flight until it sells
+//   out, once through SeatInventory's CAS loop and once through a plain int
+//   behind a mutex (the old scheme). Both must sell exactly the capacity.
+// mixed: threads pick random flights out of `flights` (default 10000) and run
+//   70% availability reads, 20% reserve/release pairs and 10% hold/confirm or
+//   hold/release cycles.
+
+static void contention(int threads) {
+    const int capacity = 4000000;
+    FlightStore store;
+    store.append().seats.store(capacity);
+    SeatInventory inventory(store);
+
+    vector<long> sold(threads, 0);
+    vector<thread> workers;
+    Stopwatch sw;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            long n = 0;
+            while (inventory.reserve(0, 1)) n++;
+            sold[t] = n;
+        });
+    }
+    for (thread& w : workers) w.join();
+    double cas = sw.seconds();
+    long total = 0;
+    for (long n : sold) total += n;
+    cout << "contention  atomic  threads=" << threads << "  reserve/s=" << static_cast<long>(total / cas)
+         << "  sold=" << total << (total == capacity ? "" : "  OVERSOLD/UNDERSOLD") << "\n";
+
+    int seats = capacity;
+    mutex lock;
+    workers.clear();
+    sw.reset();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            long n = 0;
+            for (;;) {
+                lock_guard<mutex> guard(lock);
+                if (seats <= 0) break;
+                seats--;
+                n++;
+            }
+            sold[t] = n;
+        });
+    }
+    for (thread& w : workers) w.join();
+    double locked = sw.seconds();
+    total = 0;
+    for (long n : sold) total += n;
+    cout << "contention  mutex   threads=" << threads << "  reserve/s=" << static_cast<long>(total / locked)
+         << "  sold=" << total << "\n";
+}
+
+static void mixed(int threads, int flightCount) {
+    const long opsPerThread = 2000000;
+    FlightStore store;
+    for (int i = 0; i < flightCount; ++i) store.append().seats.store(1 << 20);
+    SeatInventory inventory(store);
+
+    vector<long> checksums(threads, 0);
+    vector<thread> workers;
+    Stopwatch sw;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            mt19937 rng(1234 + t);
+            uniform_int_distribution<int> pickFlight(0, flightCount - 1);
+            uniform_int_distribution<int> pickOp(0, 99);
+            long sum = 0;
+            for (long i = 0; i < opsPerThread; ++i) {
+                int slot = pickFlight(rng);
+                int op = pickOp(rng);
+                if (op < 70) {
+                    sum += inventory.available(slot);
+                } else if (op < 90) {
+                    if (inventory.reserve(slot, 1)) inventory.release(slot, 1);
+                } else {
+                    uint64_t hold = inventory.placeHold(slot, 2, 1000);
+                    if (op & 1) sum += inventory.confirmHold(hold);
+                    else sum += inventory.releaseHold(hold);
+                }
+            }
+            checksums[t] = sum;
+        });
+    }
+    for (thread& w : workers) w.join();
+    double secs = sw.seconds();
+    long checksum = 0;
+    for (long c : checksums) checksum += c;
+    cout << "mixed       flights=" << flightCount << "  threads=" << threads
+         << "  ops/s=" << static_cast<long>(threads * opsPerThread / secs)
+         << "  holds=" << inventory.activeHolds() << "  checksum=" << checksum << "\n";
+}
+
+int main(int argc, char** argv) {
+    int threads = static_cast<int>(argOr(argc, argv, 1, 16));
+    int flightCount = static_cast<int>(argOr(argc, argv, 2, 10000));
+    contention(threads);
+    for (int t = 1; t <= threads; t *= 2) mixed(t, flightCount);
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include "fms.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Saves a FlightSystem holding N flights between A airports and B bookings
+// to a binary snapshot, then loads it into a fresh FlightSystem, reporting
+// both times, the file size and the loaded system's resident memory. A few
+// bookings and routes are compared between the two systems.
+// Usage: bench_snapshot [flights] [bookings] [airports] [path]
+
+int main(int argc, char** argv) {
+    long n = argOr(argc, argv, 1, 1000000);
+    long bookingCount = argOr(argc, argv, 2, 10000000);
+    int airports = static_cast<int>(argOr(argc, argv, 3, 2000));
+    string path = argc > 4 ? argv[4] : "bench_snapshot.bin";
+
+    int seatsPerFlight = static_cast<int>(bookingCount / max(1L, n)) + 8;
+    mt19937 rng(42);
+    Stopwatch sw;
+    {
+        FlightSystem source;
+        for (long i = 0; i < n; ++i) {
+            int a = static_cast<int>(rng() % airports), b = static_cast<int>(rng() % airports);
+            source.addFlightParams(makeFlightId(i), "AP" + to_string(a), "AP" + to_string(b),
+                                   100 + static_cast<int>(rng() % 5000), seatsPerFlight);
+        }
+        const long BATCH = 100000;
+        vector<pair<string, string>> requests;
+        for (long done = 0; done < bookingCount; done += BATCH) {
+            requests.clear();
+            for (long i = done; i < min(bookingCount, done + BATCH); ++i) {
+                requests.push_back({makeFlightId(rng() % n), "Passenger" + to_string(i)});
+            }
+            source.bookBatch(requests);
+        }
+        cout << "flights=" << n << "  bookings=" << bookingCount << "  airports=" << airports
+             << "  build s=" << sw.seconds() << "\n";
+
+        sw.reset();
+        if (!source.saveSnapshot(path)) {
+            cout << "save failed\n";
+            return 1;
+        }
+        double save = sw.seconds();
+        struct stat st;
+        stat(path.c_str(), &st);
+        cout << "save s=" << save << "  file MiB=" << st.st_size / (1024.0 * 1024.0) << "\n";
+
+        size_t rssBefore = currentRssBytes();
+        FlightSystem loaded;
+        sw.reset();
+        bool ok = loaded.loadSnapshot(path);
+        double load = sw.seconds();
+        cout << "load s=" << load << (ok ? "" : "  FAILED") << "  loaded RSS MiB="
+             << (currentRssBytes() - rssBefore) / (1024.0 * 1024.0) << "\n";
+
+        long mismatches = 0;
+        for (int q = 0; q < 100; ++q) {
+            string id = makeFlightId(rng() % n);
+            mismatches += source.getBookingsForFlight(id) != loaded.getBookingsForFlight(id);
+            string a = "AP" + to_string(rng() % airports), b = "AP" + to_string(rng() % airports);
+            mismatches += source.dijkstraPath(a, b).first != loaded.dijkstraPath(a, b).first;
+        }
+        if (mismatches) cout << "MISMATCHES=" << mismatches << "\n";
+    }
+    remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include "fms.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Durable booking throughput through the write-ahead log.
+// Usage: bench_wal [threads] [seconds per run] [log path]
+//
+// Each thread books one seat at a time with bookBatch, so every booking is
+// its own commit, for a fixed time per run. The runs cover LOG_SYNCED with
+// group-commit windows from 0 to 2 ms, then LOG_WRITTEN and LOG_BUFFERED and
+// no log at all for reference; records/sync is how many bookings shared each
+// fdatasync. The last run's log is replayed into a fresh system to time
+// recovery.
+
+struct Run {
+    const char* name;
+    bool logged;
+    LogDurability durability;
+    int windowMicros;
+};
+
+int main(int argc, char** argv) {
+    int threads = static_cast<int>(argOr(argc, argv, 1, 32));
+    double seconds = argOr(argc, argv, 2, 2);
+    string path = argc > 3 ? argv[3] : "bench_wal.log";
+    const int flightCount = 1000;
+
+    const Run runs[] = {
+        {"synced   window=0us   ", true, LOG_SYNCED, 0},
+        {"synced   window=50us  ", true, LOG_SYNCED, 50},
+        {"synced   window=200us ", true, LOG_SYNCED, 200},
+        {"synced   window=1000us", true, LOG_SYNCED, 1000},
+        {"synced   window=2000us", true, LOG_SYNCED, 2000},
+        {"written               ", true, LOG_WRITTEN, 0},
+        {"buffered              ", true, LOG_BUFFERED, 0},
+        {"no log                ", false, LOG_SYNCED, 0},
+    };
+    cout << "threads=" << threads << "  seconds/run=" << seconds << "\n";
+    for (const Run& run : runs) {
+        remove(path.c_str());
+        FlightSystem fms;
+        if (run.logged && fms.openLog(path, run.durability, run.windowMicros) < 0) {
+            cout << "cannot open " << path << "\n";
+            return 1;
+        }
+        for (int i = 0; i < flightCount; ++i) {
+            fms.addFlightParams(makeFlightId(i), "AP" + to_string(i % 50), "AP" + to_string((i * 7 + 1) % 50),
+                                500, 1 << 30);
+        }
+        LogStats before = fms.logStats();
+
+        vector<long> booked(threads, 0);
+        vector<thread> workers;
+        Stopwatch sw;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                vector<pair<string, string>> request(1);
+                long n = 0;
+                while (sw.seconds() < seconds) {
+                    request[0] = {makeFlightId((t * 131 + n) % flightCount), "Passenger" + to_string(n)};
+                    n += fms.bookBatch(request)[0] > 0;
+                }
+                booked[t] = n;
+            });
+        }
+        for (thread& w : workers) w.join();
+        double elapsed = sw.seconds();
+        long total = 0;
+        for (long n : booked) total += n;
+        LogStats after = fms.logStats();
+        uint64_t syncs = after.syncs - before.syncs;
+        cout << run.name << "  bookings/s=" << static_cast<long>(total / elapsed);
+        if (run.logged) {
+            cout << "  syncs/s=" << static_cast<long>(syncs / elapsed) << "  records/sync="
+                 << (syncs ? static_cast<double>(after.records - before.records) / syncs : 0.0)
+                 << "  MiB/s=" << (after.bytes - before.bytes) / elapsed / (1024.0 * 1024.0);
+        }
+        cout << "\n";
+        if (!run.logged || run.durability != LOG_BUFFERED) continue;
+
+        fms.closeLog();
+        FlightSystem recovered;
+        sw.reset();
+        long long replayed = recovered.openLog(path, LOG_BUFFERED);
+        double replay = sw.seconds();
+        cout << "replay                  records=" << replayed << "  s=" << replay << "  records/s="
+             << static_cast<long>(replayed / replay) << "\n";
+    }
+    remove(path.c_str());
+    return 0;
+}
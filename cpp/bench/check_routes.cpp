@@ -0,0 +1,109 @@
+#include "fms.h"
+#include "bench_graphs.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Compares every RouteMode against ROUTE_FULL on all pairs of a random
+// 40-airport network (with coordinates, so A* applies), checking each
+// returned route is made of existing flights and adds up to its distance.
+// Runs with the contraction hierarchy published, stale after cancellations,
+// and republished.
+// Usage: check_routes [seed] [airports] [flights]
+
+static const RouteMode MODES[] = {ROUTE_EARLY_EXIT, ROUTE_BIDIRECTIONAL, ROUTE_ASTAR, ROUTE_AUTO, ROUTE_CONTRACTED};
+static const char* MODE_NAMES[] = {"early exit", "bidirectional", "astar", "auto", "contracted"};
+
+// Shortest active flight between each pair of airports, either direction.
+typedef map<pair<string, string>, int> LegMap;
+
+static LegMap activeLegs(const FlightSystem& fms) {
+    LegMap legs;
+    for (const Flight& f : fms.listFlights()) {
+        if (!f.active) continue;
+        string from = f.source.str(), to = f.destination.str();
+        pair<string, string> key = minmax(from, to);
+        auto it = legs.find(key);
+        if (it == legs.end() || f.distance < it->second) legs[key] = f.distance;
+    }
+    return legs;
+}
+
+static int routeLength(const LegMap& legs, const vector<string>& path) {
+    long total = 0;
+    for (size_t i = 1; i < path.size(); ++i) {
+        auto it = legs.find(minmax(path[i - 1], path[i]));
+        if (it == legs.end()) return -1;
+        total += it->second;
+    }
+    return static_cast<int>(total);
+}
+
+static void compareModes(FlightSystem& fms, const LegMap& legs, int airports, const string& stage) {
+    for (int a = 0; a < airports; ++a) {
+        for (int b = 0; b < airports; ++b) {
+            string from = "AP" + to_string(a), to = "AP" + to_string(b);
+            pair<int, vector<string>> full = fms.dijkstraPath(from, to, ROUTE_FULL);
+            for (int m = 0; m < 5; ++m) {
+                pair<int, vector<string>> route = fms.dijkstraPath(from, to, MODES[m]);
+                string what = stage + " " + MODE_NAMES[m] + " " + from + " -> " + to;
+                expect(route.first == full.first, what + ": distance " + to_string(route.first) + " vs "
+                                                  + to_string(full.first));
+                if (route.first == INT_MAX) {
+                    expect(route.second.empty(), what + ": route without distance");
+                    continue;
+                }
+                expect(!route.second.empty() && route.second.front() == from && route.second.back() == to,
+                       what + ": endpoints");
+                expect(routeLength(legs, route.second) == route.first, what + ": route length");
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    unsigned seed = static_cast<unsigned>(argOr(argc, argv, 1, 15));
+    int airports = static_cast<int>(argOr(argc, argv, 2, 40));
+    int flightCount = static_cast<int>(argOr(argc, argv, 3, 100));
+
+    mt19937 rng(seed);
+    uniform_real_distribution<double> latDist(30, 60), lonDist(-20, 40), stretch(1.0, 1.5);
+    vector<double> lat(airports), lon(airports);
+    for (int i = 0; i < airports; ++i) {
+        lat[i] = latDist(rng);
+        lon[i] = lonDist(rng);
+    }
+
+    FlightSystem fms;
+    for (int i = 0; i < flightCount; ++i) {
+        int a = static_cast<int>(rng() % airports), b = static_cast<int>(rng() % airports);
+        if (a == b) continue;
+        string from = "AP" + to_string(a), to = "AP" + to_string(b);
+        // At least the great-circle distance, so the A* bound holds.
+        int d = static_cast<int>(ceil(greatCircleKm(lat[a], lon[a], lat[b], lon[b]) * stretch(rng)));
+        fms.addFlightParams(makeFlightId(i), from, to, d, 1);
+    }
+    for (int i = 0; i < airports; ++i) fms.setAirportCoordinates("AP" + to_string(i), lat[i], lon[i]);
+
+    expect(fms.publishSchedule(), "publish hierarchy");
+    compareModes(fms, activeLegs(fms), airports, "published");
+
+    // Cancelling flights leaves the hierarchy stale until it is republished.
+    for (int i = 0; i < flightCount; i += 6) fms.cancelFlightById(makeFlightId(i));
+    LegMap legs = activeLegs(fms);
+    compareModes(fms, legs, airports, "stale");
+    expect(fms.publishSchedule(), "republish hierarchy");
+    compareModes(fms, legs, airports, "republished");
+
+    expect(fms.dijkstraPath("AP0", "NOWHERE", ROUTE_CONTRACTED).first == INT_MAX, "unknown airport");
+    if (checkFailures() == 0) printf("route modes OK\n");
+    return checkFailures() != 0;
+}
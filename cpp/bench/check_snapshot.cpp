@@ -0,0 +1,88 @@
+#include "fms.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Saves a small FlightSystem with cancelled and timetabled flights, bookings,
+// cancelled bookings and an open hold, loads the snapshot into a fresh
+// system and checks that flights, bookings, routes and the next booking ID
+// survived. A truncated copy of the file must be rejected without touching
+// the system it was loaded into.
+// Usage: check_snapshot [path]
+
+static bool sameFlight(const Flight& a, const Flight& b) {
+    return a.flightID == b.flightID && a.source == b.source && a.destination == b.destination
+        && a.distance == b.distance && a.seats.load() == b.seats.load() && a.active.load() == b.active.load()
+        && a.departureTime == b.departureTime && a.arrivalTime == b.arrivalTime;
+}
+
+int main(int argc, char** argv) {
+    string path = argc > 1 ? argv[1] : "check_snapshot.bin";
+    const int flightCount = 300, airports = 20;
+
+    mt19937 rng(23);
+    FlightSystem source;
+    for (int i = 0; i < flightCount; ++i) {
+        int a = static_cast<int>(rng() % airports), b = static_cast<int>(rng() % airports);
+        int64_t depart = i % 3 ? 0 : 1700000000 + i * 600;
+        source.addFlightParams(makeFlightId(i), "AP" + to_string(a), "AP" + to_string(b),
+                               100 + static_cast<int>(rng() % 900), 4 + static_cast<int>(rng() % 8),
+                               depart, depart ? depart + 3600 : 0);
+    }
+    vector<pair<string, string>> requests;
+    for (int i = 0; i < 1500; ++i) requests.push_back({makeFlightId(rng() % flightCount), "Passenger" + to_string(i)});
+    vector<int> ids = source.bookBatch(requests);
+    for (size_t i = 0; i < ids.size(); i += 7) {
+        if (ids[i] > 0) source.cancelBookingById(requests[i].first, ids[i]);
+    }
+    for (int i = 0; i < flightCount; i += 11) source.cancelFlightById(makeFlightId(i));
+    source.scheduleFlightById(makeFlightId(0));
+    uint64_t hold = source.holdSeats(makeFlightId(1), 1, 60000);
+
+    expect(source.saveSnapshot(path), "saveSnapshot");
+    FlightSystem loaded;
+    expect(loaded.loadSnapshot(path), "loadSnapshot");
+
+    vector<Flight> before = source.listFlights(), after = loaded.listFlights();
+    expect(before.size() == after.size(), "flight count");
+    if (hold) source.releaseHold(hold);  // held seats are saved as free
+    before = source.listFlights();
+    for (size_t i = 0; i < before.size() && i < after.size(); ++i) {
+        expect(sameFlight(before[i], after[i]), "flight " + before[i].flightID.str());
+    }
+    for (int i = 0; i < flightCount; ++i) {
+        string id = makeFlightId(i);
+        expect(source.getBookingsForFlight(id) == loaded.getBookingsForFlight(id), "bookings of " + id);
+    }
+    for (int a = 0; a < airports; ++a) {
+        string from = "AP" + to_string(a);
+        expect(source.searchFlightsBySourceNonInteractive(from).size()
+                   == loaded.searchFlightsBySourceNonInteractive(from).size(), "flights from " + from);
+        for (int b = 0; b < airports; ++b) {
+            string to = "AP" + to_string(b);
+            expect(source.dijkstraPath(from, to, ROUTE_FULL) == loaded.dijkstraPath(from, to, ROUTE_FULL),
+                   "route " + from + " -> " + to);
+        }
+    }
+    vector<pair<string, string>> next{{makeFlightId(2), "Next"}};
+    expect(source.bookBatch(next) == loaded.bookBatch(next), "next booking ID");
+
+    {
+        ifstream in(path, ios::binary);
+        string bytes((istreambuf_iterator<char>(in)), {});
+        ofstream(path, ios::binary | ios::trunc) << bytes.substr(0, bytes.size() / 2);
+    }
+    expect(!loaded.loadSnapshot(path), "truncated snapshot rejected");
+    expect(loaded.listFlights().size() == after.size(), "rejected snapshot leaves the system as it was");
+
+    remove(path.c_str());
+    if (checkFailures() == 0) printf("snapshot round trip OK\n");
+    return checkFailures() != 0;
+}
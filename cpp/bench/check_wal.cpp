@@ -0,0 +1,95 @@
+#include "fms.h"
+#include "bench_common.h"
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Books and cancels seats on a logged FlightSystem, with flights added,
+// cancelled and rescheduled in between, and checks that replaying a copy of
+// the log into a fresh system reproduces the flights, bookings and next
+// booking ID. The same is checked after a checkpoint and more changes,
+// recovered as loadSnapshot plus the remaining log.
+// Usage: check_wal [log path] [snapshot path]
+
+static void compareSystems(FlightSystem& expected, FlightSystem& actual, int flightCount, const string& stage) {
+    vector<Flight> a = expected.listFlights(), b = actual.listFlights();
+    expect(a.size() == b.size(), stage + ": flight count");
+    for (size_t i = 0; i < a.size() && i < b.size(); ++i) {
+        expect(a[i].flightID == b[i].flightID && a[i].seats.load() == b[i].seats.load()
+                   && a[i].active.load() == b[i].active.load() && a[i].distance == b[i].distance,
+               stage + ": flight " + a[i].flightID.str());
+    }
+    for (int i = 0; i < flightCount; ++i) {
+        string id = makeFlightId(i);
+        expect(expected.getBookingsForFlight(id) == actual.getBookingsForFlight(id), stage + ": bookings of " + id);
+    }
+    vector<pair<string, string>> next{{makeFlightId(1), "Next"}};
+    expect(expected.bookBatch(next) == actual.bookBatch(next), stage + ": next booking ID");
+}
+
+// Books a round of passengers, then cancels every fifth booking made.
+static void bookAndCancel(FlightSystem& fms, mt19937& rng, int flightCount, int round) {
+    vector<pair<string, string>> requests;
+    for (int i = 0; i < 400; ++i) {
+        requests.push_back({makeFlightId(rng() % flightCount), "P" + to_string(round) + "_" + to_string(i)});
+    }
+    vector<int> ids = fms.bookBatch(requests);
+    for (size_t i = 0; i < ids.size(); i += 5) {
+        if (ids[i] > 0) fms.cancelBookingById(requests[i].first, ids[i]);
+    }
+}
+
+int main(int argc, char** argv) {
+    string logPath = argc > 1 ? argv[1] : "check_wal.log";
+    string snapshotPath = argc > 2 ? argv[2] : "check_wal.bin";
+    string copyPath = logPath + ".copy";
+    const int flightCount = 100;
+    remove(logPath.c_str());
+    remove(copyPath.c_str());
+
+    mt19937 rng(24);
+    FlightSystem live;
+    expect(live.openLog(logPath, LOG_WRITTEN) == 0, "open empty log");
+    for (int i = 0; i < flightCount; ++i) {
+        live.addFlightParams(makeFlightId(i), "AP" + to_string(i % 10), "AP" + to_string((i * 3 + 1) % 10),
+                             200 + i, 10);
+    }
+    bookAndCancel(live, rng, flightCount, 0);
+    live.cancelFlightById(makeFlightId(3));
+    live.cancelFlightById(makeFlightId(4));
+    live.scheduleFlightById(makeFlightId(4));
+    bookAndCancel(live, rng, flightCount, 1);
+
+    // LOG_WRITTEN has written every record by the time the calls return.
+    {
+        ifstream in(logPath, ios::binary);
+        ofstream(copyPath, ios::binary) << in.rdbuf();
+    }
+    FlightSystem replayed;
+    expect(replayed.openLog(copyPath, LOG_WRITTEN) > 0, "replay log");
+    compareSystems(live, replayed, flightCount, "replay");
+    replayed.closeLog();
+
+    expect(live.checkpoint(snapshotPath), "checkpoint");
+    bookAndCancel(live, rng, flightCount, 2);
+    live.cancelFlightById(makeFlightId(5));
+    bookAndCancel(live, rng, flightCount, 3);
+    expect(live.closeLog(), "close log after checkpoint");
+
+    FlightSystem recovered;
+    expect(recovered.loadSnapshot(snapshotPath), "load checkpoint snapshot");
+    expect(recovered.openLog(logPath, LOG_WRITTEN) > 0, "replay log after checkpoint");
+    recovered.closeLog();
+    compareSystems(live, recovered, flightCount, "checkpoint");
+
+    remove(logPath.c_str());
+    remove(copyPath.c_str());
+    remove(snapshotPath.c_str());
+    if (checkFailures() == 0) printf("log replay OK\n");
+    return checkFailures() != 0;
+}
@@ -0,0 +1,88 @@
+#include "fms.h"
+#include <algorithm>
+
+using namespace std;
+
+BookingTable::BookingTable() : flights(), locations(1, Location{-1, -1}), nextId(1) {}
+
+int BookingTable::add(int flightIndex, const std::string& passengerName) {
+    if (flightIndex >= static_cast<int>(flights.size())) flights.resize(flightIndex + 1);
+    FlightBookings& fb = flights[flightIndex];
+    int id = nextId++;
+    locations.push_back({flightIndex, static_cast<int>(fb.records.size())});
+    fb.records.push_back({id, passengerName});
+    fb.live++;
+    return id;
+}
+
+void BookingTable::reserve(int flightIndex, int extra) {
+    if (flightIndex >= static_cast<int>(flights.size())) flights.resize(flightIndex + 1);
+    // Grow geometrically so repeated small batches stay amortized O(1).
+    vector<BookingRecord>& records = flights[flightIndex].records;
+    if (records.size() + extra > records.capacity()) {
+        records.reserve(max(records.size() + extra, records.capacity() * 2));
+    }
+    if (locations.size() + extra > locations.capacity()) {
+        locations.reserve(max(locations.size() + extra, locations.capacity() * 2));
+    }
+}
+
+bool BookingTable::cancel(int flightIndex, int bookingId) {
+    if (bookingId <= 0 || bookingId >= nextId) return false;
+    Location& loc = locations[bookingId];
+    if (loc.flight != flightIndex) return false;
+    FlightBookings& fb = flights[flightIndex];
+    BookingRecord& r = fb.records[loc.slot];
+    r.bookingId = 0;
+    r.passengerName.clear();
+    r.passengerName.shrink_to_fit();
+    loc = {-1, -1};
+    fb.live--;
+    int dead = static_cast<int>(fb.records.size()) - fb.live;
+    if (dead >= 16 && dead > fb.live) compact(flightIndex);
+    return true;
+}
+
+int BookingTable::flightOf(int bookingId) const {
+    if (bookingId <= 0 || bookingId >= nextId) return -1;
+    return locations[bookingId].flight;
+}
+
+int BookingTable::liveCount(int flightIndex) const {
+    if (flightIndex < 0 || flightIndex >= static_cast<int>(flights.size())) return 0;
+    return flights[flightIndex].live;
+}
+
+void BookingTable::clear() {
+    flights.clear();
+    locations.assign(1, Location{-1, -1});
+    nextId = 1;
+}
+
+void BookingTable::reset(int flightCount, int nextBookingId) {
+    flights.clear();
+    flights.resize(flightCount);
+    locations.assign(max(1, nextBookingId), Location{-1, -1});
+    nextId = max(1, nextBookingId);
+}
+
+void BookingTable::restore(int flightIndex, std::vector<BookingRecord> records) {
+    FlightBookings& fb = flights[flightIndex];
+    for (size_t i = 0; i < records.size(); ++i) {
+        locations[records[i].bookingId] = {flightIndex, static_cast<int>(i)};
+    }
+    fb.live = static_cast<int>(records.size());
+    fb.records = std::move(records);
+}
+
+void BookingTable::compact(int flightIndex) {
+    vector<BookingRecord>& records = flights[flightIndex].records;
+    size_t out = 0;
+    for (size_t i = 0; i < records.size(); ++i) {
+        if (records[i].bookingId == 0) continue;
+        if (out != i) records[out] = std::move(records[i]);
+        locations[records[out].bookingId].slot = static_cast<int>(out);
+        out++;
+    }
+    records.resize(out);
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+// Short ASCII code (flight number, airport code) packed big-endian into
+// 64-bit words and zero padded. Comparing the words compares the text
+// lexicographically, so codes order exactly like the strings they came from,
+// and the type stays trivially copyable. Text is only produced at the CLI and
+// pybind boundary.
+template <int Words>
+struct PackedCode {
+    static const int MAX_LEN = Words * 8;
+
+    uint64_t w[Words];
+
+    PackedCode() : w() {}
+
+    // Returns false (leaving out untouched) if text is longer than MAX_LEN
+    // or contains a NUL byte.
+    static bool parse(const std::string& text, PackedCode& out) {
+        return parse(text.data(), text.size(), out);
+    }
+
+    static bool parse(const char* text, size_t length, PackedCode& out) {
+        if (length > static_cast<size_t>(MAX_LEN)) return false;
+        PackedCode code;
+        for (size_t i = 0; i < length; ++i) {
+            unsigned char c = static_cast<unsigned char>(text[i]);
+            if (c == 0) return false;
+            code.w[i / 8] |= static_cast<uint64_t>(c) << ((7 - i % 8) * 8);
+        }
+        out = code;
+        return true;
+    }
+
+    std::string str() const {
+        std::string text;
+        for (int i = 0; i < MAX_LEN; ++i) {
+            char c = static_cast<char>(w[i / 8] >> ((7 - i % 8) * 8));
+            if (c == 0) break;
+            text.push_back(c);
+        }
+        return text;
+    }
+
+    bool empty() const { return w[0] == 0; }
+
+    uint64_t hash() const {
+        uint64_t h = 0x9e3779b97f4a7c15ULL;
+        for (int i = 0; i < Words; ++i) {
+            h ^= w[i];
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ULL;
+            h ^= h >> 33;
+        }
+        return h;
+    }
+
+    friend bool operator==(const PackedCode& a, const PackedCode& b) {
+        for (int i = 0; i < Words; ++i) if (a.w[i] != b.w[i]) return false;
+        return true;
+    }
+    friend bool operator!=(const PackedCode& a, const PackedCode& b) { return !(a == b); }
+    friend bool operator<(const PackedCode& a, const PackedCode& b) {
+        for (int i = 0; i < Words; ++i) {
+            if (a.w[i] != b.w[i]) return a.w[i] < b.w[i];
+        }
+        return false;
+    }
+    friend bool operator>(const PackedCode& a, const PackedCode& b) { return b < a; }
+    friend bool operator<=(const PackedCode& a, const PackedCode& b) { return !(b < a); }
+    friend bool operator>=(const PackedCode& a, const PackedCode& b) { return !(a < b); }
+
+    friend std::ostream& operator<<(std::ostream& os, const PackedCode& code) {
+        return os << code.str();
+    }
+};
+
+// Flight numbers fit one word. Airports get two: IATA codes would fit in one,
+// but the schedule data (web/flights_db.txt) uses city names such as
+// "Bangalore", so names up to 16 characters are accepted.
+using FlightCode = PackedCode<1>;
+using AirportCode = PackedCode<2>;
+
+static_assert(std::is_trivially_copyable<FlightCode>::value, "FlightCode must stay trivially copyable");
+static_assert(sizeof(FlightCode) == 8 && sizeof(AirportCode) == 16, "codes must stay packed");
+
+namespace std {
+template <int Words>
+struct hash<PackedCode<Words>> {
+    size_t operator()(const PackedCode<Words>& code) const { return static_cast<size_t>(code.hash()); }
+};
+}
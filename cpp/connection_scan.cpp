@@ -0,0 +1,103 @@
+#include "fms.h"
+#include <algorithm>
+#include <climits>
+
+using namespace std;
+
+ConnectionScan::ConnectionScan()
+    : connections(), airportIndex(), minConnection(), connectionTimes(), defaultConnectionTime(0), epoch(0) {}
+
+size_t ConnectionScan::memoryBytes() const {
+    return connections.capacity() * sizeof(Connection) + minConnection.capacity() * sizeof(int);
+}
+
+int ConnectionScan::connectionTime(AirportCode airport) const {
+    auto it = connectionTimes.find(airport);
+    return it == connectionTimes.end() ? defaultConnectionTime : it->second;
+}
+
+void ConnectionScan::setDefaultConnectionTime(int seconds) {
+    defaultConnectionTime = max(0, seconds);
+    for (const auto& entry : airportIndex) minConnection[entry.second] = connectionTime(entry.first);
+}
+
+void ConnectionScan::setMinimumConnectionTime(AirportCode airport, int seconds) {
+    connectionTimes[airport] = max(0, seconds);
+    auto it = airportIndex.find(airport);
+    if (it != airportIndex.end()) minConnection[it->second] = connectionTimes[airport];
+}
+
+void ConnectionScan::build(const FlightStore& flights) {
+    connections = vector<Connection>();
+    airportIndex.clear();
+    minConnection.clear();
+    epoch = INT64_MAX;
+    size_t timed = 0;
+    for (int i = 0; i < flights.size(); ++i) {
+        const Flight& f = flights[i];
+        if (f.active && f.arrivalTime > f.departureTime) {
+            epoch = min(epoch, f.departureTime);
+            timed++;
+        }
+    }
+    connections.reserve(timed);
+    auto indexOf = [&](AirportCode code) {
+        auto it = airportIndex.emplace(code, static_cast<int>(minConnection.size()));
+        if (it.second) minConnection.push_back(connectionTime(code));
+        return it.first->second;
+    };
+    for (int i = 0; i < flights.size(); ++i) {
+        const Flight& f = flights[i];
+        if (!f.active || f.arrivalTime <= f.departureTime) continue;
+        // Offsets are 32-bit: a timetable may span about 68 years.
+        if (f.arrivalTime - epoch > INT32_MAX) continue;
+        connections.push_back({static_cast<int32_t>(f.departureTime - epoch), static_cast<int32_t>(f.arrivalTime - epoch),
+                               indexOf(f.source), indexOf(f.destination), i});
+    }
+    sort(connections.begin(), connections.end(), [](const Connection& a, const Connection& b) {
+        return a.departure != b.departure ? a.departure < b.departure : a.arrival < b.arrival;
+    });
+    if (connections.empty()) epoch = 0;
+}
+
+// Labels hold, per airport, the earliest time a passenger is ready to board
+// there (arrival plus the connection time; the bare arrival at the
+// destination) and the connection that got them there.
+Journey ConnectionScan::earliestArrival(AirportCode from, AirportCode to, int64_t departAfter) const {
+    Journey journey{-1, {}};
+    auto a = airportIndex.find(from), b = airportIndex.find(to);
+    if (a == airportIndex.end() || b == airportIndex.end()) return journey;
+    int s = a->second, t = b->second;
+    if (s == t) {
+        journey.arrival = departAfter;
+        return journey;
+    }
+    int64_t start = max<int64_t>(0, departAfter - epoch);
+    if (connections.empty() || start > connections.back().departure) return journey;
+
+    SearchLabels& ready = DijkstraContext::local().labels[0];
+    ready.reset(static_cast<int>(minConnection.size()));
+    ready.set(s, static_cast<int>(start), -1);
+    auto first = lower_bound(connections.begin(), connections.end(), start,
+                             [](const Connection& c, int64_t time) { return c.departure < time; });
+    for (auto it = first; it != connections.end(); ++it) {
+        const Connection& c = *it;
+        if (c.departure >= ready.dist(t)) break;
+        if (ready.dist(c.from) > c.departure) continue;
+        int64_t boardAgain = c.to == t ? c.arrival : static_cast<int64_t>(c.arrival) + minConnection[c.to];
+        if (boardAgain < ready.dist(c.to)) {
+            ready.set(c.to, static_cast<int>(min<int64_t>(boardAgain, INT_MAX - 1)),
+                      static_cast<int>(it - connections.begin()));
+        }
+    }
+    if (ready.dist(t) == INT_MAX) return journey;
+
+    journey.arrival = epoch + ready.dist(t);
+    for (int v = t; ready.parent(v) != -1;) {
+        const Connection& c = connections[ready.parent(v)];
+        journey.flights.push_back(c.flight);
+        v = c.from;
+    }
+    reverse(journey.flights.begin(), journey.flights.end());
+    return journey;
+}
@@ -0,0 +1,57 @@
+#include "fms.h"
+
+using namespace std;
+
+// Unions from scratch over the current routes; each route is seen from its
+// lower-indexed airport only.
+void AirportGraph::refreshConnectivity() {
+    if (!connectivityStale) return;
+    int n = static_cast<int>(adj.size());
+    connectivity.init(n);
+    componentTotal = n;
+    for (int u = 0; u < n; ++u) {
+        for (const Arc& a : adj[u]) {
+            if (a.to > u && connectivity.unite(u, a.to)) componentTotal--;
+        }
+    }
+    connectivityStale = false;
+}
+
+bool AirportGraph::connected(AirportCode a, AirportCode b) {
+    auto x = airportIndex.find(a), y = airportIndex.find(b);
+    if (x == airportIndex.end() || y == airportIndex.end()) return false;
+    refreshConnectivity();
+    return connectivity.find(x->second) == connectivity.find(y->second);
+}
+
+int AirportGraph::componentSize(AirportCode airport) {
+    auto it = airportIndex.find(airport);
+    if (it == airportIndex.end()) return 0;
+    refreshConnectivity();
+    return connectivity.size[connectivity.find(it->second)];
+}
+
+int AirportGraph::componentCount() {
+    refreshConnectivity();
+    return componentTotal;
+}
+
+// Components are numbered as their first airport comes up, so one pass over
+// the airports fills every list in index order without sorting.
+std::vector<std::vector<AirportCode>> AirportGraph::components() {
+    refreshConnectivity();
+    int n = static_cast<int>(adj.size());
+    vector<int> slot(n, -1);
+    vector<vector<AirportCode>> groups;
+    groups.reserve(componentTotal);
+    for (int u = 0; u < n; ++u) {
+        int root = connectivity.find(u);
+        if (slot[root] == -1) {
+            slot[root] = static_cast<int>(groups.size());
+            groups.emplace_back();
+            groups.back().reserve(connectivity.size[root]);
+        }
+        groups[slot[root]].push_back(indexToAirport[u]);
+    }
+    return groups;
+}
@@ -0,0 +1,289 @@
+#include "fms.h"
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <queue>
+
+using namespace std;
+
+namespace {
+using PII = pair<int,int>;
+using MinHeap = priority_queue<PII, vector<PII>, greater<PII>>;
+
+// Witness searches give up after this many settled airports; a missed
+// witness only costs an unnecessary shortcut, never a wrong distance.
+// Ordering estimates use the cheaper limit.
+const int WITNESS_SETTLE_LIMIT = 400;
+const int ESTIMATE_SETTLE_LIMIT = 40;
+
+struct ChEdge {
+    int to;
+    int weight;
+    int middle;
+};
+
+struct Shortcut {
+    int from;
+    int to;
+    int weight;
+};
+}
+
+ContractionHierarchy::ContractionHierarchy()
+    : rank(), offsets(), targets(), weights(), middles(), shortcuts(0) {}
+
+void ContractionHierarchy::clear() {
+    rank.clear();
+    offsets.clear();
+    targets.clear();
+    weights.clear();
+    middles.clear();
+    shortcuts = 0;
+}
+
+size_t ContractionHierarchy::memoryBytes() const {
+    return (rank.capacity() + offsets.capacity() + targets.capacity() + weights.capacity()
+            + middles.capacity()) * sizeof(int);
+}
+
+void ContractionHierarchy::build(const CsrGraph& g) {
+    clear();
+    int n = g.nodeCount();
+    vector<vector<ChEdge>> live(n);
+    for (int u = 0; u < n; ++u) {
+        for (int e = g.begin(u); e < g.end(u); ++e) live[u].push_back({g.targets[e], g.weights[e], -1});
+    }
+
+    vector<int> dist(n, INT_MAX);
+    vector<int> touched;
+    vector<char> isTarget(n, 0);
+    RadixHeap pq;
+    // Bounded Dijkstra from src that never passes through skip; it also
+    // stops once all `targets` marked in isTarget are settled.
+    auto witness = [&](int src, int skip, int limit, int targets, int maxSettled) {
+        pq.clear();
+        dist[src] = 0;
+        touched.push_back(src);
+        pq.push(0, src);
+        int settled = 0;
+        while (!pq.empty() && targets > 0) {
+            auto [d, u] = pq.top(); pq.pop();
+            if (d != dist[u]) continue;
+            if (d > limit || ++settled > maxSettled) break;
+            if (isTarget[u]) targets--;
+            for (const ChEdge& e : live[u]) {
+                if (e.to == skip) continue;
+                int nd = d + e.weight;
+                if (nd < dist[e.to]) {
+                    if (dist[e.to] == INT_MAX) touched.push_back(e.to);
+                    dist[e.to] = nd;
+                    pq.push(nd, e.to);
+                }
+            }
+        }
+    };
+    auto resetWitness = [&]() {
+        for (int u : touched) dist[u] = INT_MAX;
+        touched.clear();
+    };
+    // Shortcuts needed to contract v, one per unordered neighbour pair.
+    auto findShortcuts = [&](int v, int maxSettled, vector<Shortcut>& out) {
+        out.clear();
+        const vector<ChEdge>& nbrs = live[v];
+        for (size_t i = 0; i + 1 < nbrs.size(); ++i) {
+            int limit = 0;
+            for (size_t j = i + 1; j < nbrs.size(); ++j) {
+                limit = max(limit, nbrs[i].weight + nbrs[j].weight);
+                isTarget[nbrs[j].to] = 1;
+            }
+            witness(nbrs[i].to, v, limit, static_cast<int>(nbrs.size() - i - 1), maxSettled);
+            for (size_t j = i + 1; j < nbrs.size(); ++j) {
+                int via = nbrs[i].weight + nbrs[j].weight;
+                if (dist[nbrs[j].to] > via) out.push_back({nbrs[i].to, nbrs[j].to, via});
+                isTarget[nbrs[j].to] = 0;
+            }
+            resetWitness();
+        }
+    };
+
+    // Edge difference plus terms that spread contraction evenly: airports
+    // next to many contracted ones, or high in the hierarchy already, wait.
+    vector<int> contractedNeighbours(n, 0);
+    vector<int> level(n, 0);
+    vector<Shortcut> found;
+    auto priority = [&](int v) {
+        findShortcuts(v, ESTIMATE_SETTLE_LIMIT, found);
+        return 2 * static_cast<int>(found.size()) - static_cast<int>(live[v].size())
+             + contractedNeighbours[v] + level[v];
+    };
+
+    MinHeap order;
+    for (int v = 0; v < n; ++v) order.push({priority(v), v});
+
+    rank.assign(n, -1);
+    vector<vector<ChEdge>> upward(n);
+    int next = 0;
+    while (!order.empty()) {
+        int v = order.top().second;
+        order.pop();
+        if (rank[v] >= 0) continue;
+        // Lazy update: re-evaluate and requeue if v is no longer the cheapest.
+        int p = priority(v);
+        if (!order.empty() && p > order.top().first) {
+            order.push({p, v});
+            continue;
+        }
+        rank[v] = next++;
+        findShortcuts(v, WITNESS_SETTLE_LIMIT, found);
+        upward[v] = live[v];
+        for (const Shortcut& sc : found) {
+            bool updated = false;
+            for (ChEdge& e : live[sc.from]) {
+                if (e.to != sc.to) continue;
+                updated = true;
+                if (sc.weight < e.weight) {
+                    e.weight = sc.weight;
+                    e.middle = v;
+                    for (ChEdge& back : live[sc.to]) {
+                        if (back.to == sc.from) {
+                            back.weight = sc.weight;
+                            back.middle = v;
+                        }
+                    }
+                }
+                break;
+            }
+            if (!updated) {
+                live[sc.from].push_back({sc.to, sc.weight, v});
+                live[sc.to].push_back({sc.from, sc.weight, v});
+            }
+            shortcuts++;
+        }
+        for (const ChEdge& e : live[v]) {
+            vector<ChEdge>& other = live[e.to];
+            for (size_t i = 0; i < other.size(); ++i) {
+                if (other[i].to == v) {
+                    other[i] = other.back();
+                    other.pop_back();
+                    break;
+                }
+            }
+            contractedNeighbours[e.to]++;
+            level[e.to] = max(level[e.to], level[v] + 1);
+        }
+        live[v].clear();
+        live[v].shrink_to_fit();
+    }
+
+    offsets.assign(n + 1, 0);
+    for (int u = 0; u < n; ++u) offsets[u + 1] = offsets[u] + static_cast<int>(upward[u].size());
+    targets.resize(offsets[n]);
+    weights.resize(offsets[n]);
+    middles.resize(offsets[n]);
+    for (int u = 0; u < n; ++u) {
+        int k = offsets[u];
+        for (const ChEdge& e : upward[u]) {
+            targets[k] = e.to;
+            weights[k] = e.weight;
+            middles[k] = e.middle;
+            k++;
+        }
+    }
+}
+
+// The edge between a and b is stored with whichever of them ranks lower.
+int ContractionHierarchy::middleOf(int a, int b) const {
+    if (rank[a] > rank[b]) swap(a, b);
+    int best = INT_MAX, middle = -1;
+    for (int e = offsets[a]; e < offsets[a + 1]; ++e) {
+        if (targets[e] == b && weights[e] < best) {
+            best = weights[e];
+            middle = middles[e];
+        }
+    }
+    return middle;
+}
+
+// Appends the airports after a on the original path a -> b.
+void ContractionHierarchy::unpack(int a, int b, std::vector<std::pair<int, int>>& pending,
+                                  std::vector<int>& path) const {
+    pending.assign(1, {a, b});
+    while (!pending.empty()) {
+        auto [x, y] = pending.back();
+        pending.pop_back();
+        int m = middleOf(x, y);
+        if (m < 0) {
+            path.push_back(y);
+        } else {
+            pending.push_back({m, y});
+            pending.push_back({x, m});
+        }
+    }
+}
+
+int ContractionHierarchy::query(int s, int t, std::vector<int>& path, int* settled) const {
+    path.clear();
+    int n = static_cast<int>(rank.size());
+    if (s < 0 || t < 0 || s >= n || t >= n) return INT_MAX;
+    DijkstraContext& ctx = DijkstraContext::local();
+    SearchLabels* labels = ctx.labels;
+    RadixHeap* pq = ctx.heap;
+    for (int side = 0; side < 2; ++side) {
+        labels[side].reset(n);
+        pq[side].clear();
+    }
+    labels[0].set(s, 0, -1);
+    labels[1].set(t, 0, -1);
+    pq[0].push(0, s);
+    pq[1].push(0, t);
+    long long best = LLONG_MAX;
+    int meet = -1, count = 0;
+
+    // Each side stops once its smallest key cannot improve the best meeting.
+    while (!pq[0].empty() || !pq[1].empty()) {
+        int side;
+        if (pq[0].empty()) side = 1;
+        else if (pq[1].empty()) side = 0;
+        else side = pq[0].top().first <= pq[1].top().first ? 0 : 1;
+        auto [d, u] = pq[side].top();
+        if (d >= best) {
+            pq[side].clear();
+            continue;
+        }
+        pq[side].pop();
+        if (d != labels[side].dist(u)) continue;
+        count++;
+        // Stall-on-demand: a higher-ranked neighbour already reached more
+        // cheaply proves u is not on a shortest up-path, so skip its edges.
+        bool stalled = false;
+        for (int e = offsets[u]; e < offsets[u + 1] && !stalled; ++e) {
+            int w = labels[side].dist(targets[e]);
+            stalled = w != INT_MAX && w + weights[e] < d;
+        }
+        int other = labels[1 - side].dist(u);
+        if (other != INT_MAX && static_cast<long long>(d) + other < best) {
+            best = static_cast<long long>(d) + other;
+            meet = u;
+        }
+        if (stalled) continue;
+        for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+            int v = targets[e], nd = d + weights[e];
+            if (nd < labels[side].dist(v)) {
+                labels[side].set(v, nd, u);
+                pq[side].push(nd, v);
+            }
+        }
+    }
+    if (settled) *settled = count;
+    if (meet < 0) return INT_MAX;
+
+    vector<int>& up = ctx.upPath;
+    up.clear();
+    for (int cur = meet; cur != -1; cur = labels[0].parent(cur)) up.push_back(cur);
+    path.push_back(s);
+    for (size_t i = up.size() - 1; i > 0; --i) unpack(up[i], up[i - 1], ctx.unpackStack, path);
+    for (int cur = meet; labels[1].parent(cur) != -1; cur = labels[1].parent(cur)) {
+        unpack(cur, labels[1].parent(cur), ctx.unpackStack, path);
+    }
+    return best > INT_MAX ? INT_MAX : static_cast<int>(best);
+}
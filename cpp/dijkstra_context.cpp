@@ -0,0 +1,73 @@
+#include "fms.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+// Index of the highest bit where key and last differ, plus one; 0 if equal.
+inline int bucketOf(uint32_t key, uint32_t last) {
+    uint32_t diff = key ^ last;
+    if (diff == 0) return 0;
+#if defined(__GNUC__)
+    return 32 - __builtin_clz(diff);
+#else
+    int bit = 0;
+    while (diff) {
+        diff >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+}
+
+RadixHeap::RadixHeap() : buckets(), last(0), count(0) {}
+
+void RadixHeap::clear() {
+    for (auto& bucket : buckets) bucket.clear();
+    last = 0;
+    count = 0;
+}
+
+void RadixHeap::push(int key, int value) {
+    buckets[bucketOf(static_cast<uint32_t>(key), last)].push_back({key, value});
+    count++;
+}
+
+const std::pair<int, int>& RadixHeap::top() {
+    if (buckets[0].empty()) pull();
+    return buckets[0].back();
+}
+
+void RadixHeap::pop() {
+    if (buckets[0].empty()) pull();
+    buckets[0].pop_back();
+    count--;
+}
+
+// Moves the smallest key into bucket 0: the first non-empty bucket holds it,
+// and once it becomes `last` every other entry there differs from it in a
+// lower bit, so the bucket empties into the ones below.
+void RadixHeap::pull() {
+    int i = 1;
+    while (buckets[i].empty()) i++;
+    auto& bucket = buckets[i];
+    last = static_cast<uint32_t>(min_element(bucket.begin(), bucket.end())->first);
+    for (const auto& entry : bucket) buckets[bucketOf(static_cast<uint32_t>(entry.first), last)].push_back(entry);
+    bucket.clear();
+}
+
+SearchLabels::SearchLabels() : labels(), epoch(0) {}
+
+void SearchLabels::reset(int n) {
+    if (labels.size() < static_cast<size_t>(n)) labels.resize(n, Label{0, INT_MAX, -1});
+    if (++epoch == 0) {
+        for (Label& label : labels) label.stamp = 0;
+        epoch = 1;
+    }
+}
+
+DijkstraContext& DijkstraContext::local() {
+    static thread_local DijkstraContext context;
+    return context;
+}
@@ -0,0 +1,117 @@
+#include "fms.h"
+#include "parallel_for.h"
+#include <climits>
+#include <new>
+
+using namespace std;
+
+namespace {
+shared_ptr<int32_t> allocateAligned(size_t count) {
+    if (count == 0) return shared_ptr<int32_t>();
+    void* p = ::operator new(count * sizeof(int32_t), align_val_t(64));
+    return shared_ptr<int32_t>(static_cast<int32_t*>(p), [](int32_t* q) {
+        ::operator delete(q, align_val_t(64));
+    });
+}
+}
+
+DistanceMatrix::DistanceMatrix() : dist(), next(), n(0), rowStride(0) {}
+
+void DistanceMatrix::resize(int size) {
+    int stride = (size + ROW_ALIGN - 1) / ROW_ALIGN * ROW_ALIGN;
+    if (size == n && dist) return;
+    n = size;
+    rowStride = stride;
+    dist = allocateAligned(static_cast<size_t>(n) * rowStride);
+    next = allocateAligned(static_cast<size_t>(n) * rowStride);
+}
+
+void AirportGraph::noteRouteChange(int u, int v, int oldWeight) {
+    // emplace keeps the first recorded weight, i.e. the one the matrix saw.
+    if (matrixValid) matrixChanges.emplace(routeKey(u, v), oldWeight);
+}
+
+// Dijkstra from s writing row s of the matrix; runs concurrently for
+// different rows, so it only reads g and writes its own row.
+void AirportGraph::computeRow(const CsrGraph& g, int s) {
+    int n = g.nodeCount();
+    int32_t* dist = matrix.distanceRow(s);
+    int32_t* first = matrix.nextHopRow(s);
+    fill(dist, dist + n, int32_t(DistanceMatrix::UNREACHABLE));
+    fill(first, first + n, -1);
+    RadixHeap& pq = DijkstraContext::local().heap[0];
+    pq.clear();
+    dist[s] = 0;
+    pq.push(0, s);
+    while (!pq.empty()) {
+        auto [d, u] = pq.top(); pq.pop();
+        if (d != dist[u]) continue;
+        for (int e = g.begin(u); e < g.end(u); ++e) {
+            int v = g.targets[e], nd = d + g.weights[e];
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                first[v] = u == s ? v : first[u];
+                pq.push(nd, v);
+            }
+        }
+    }
+}
+
+void AirportGraph::computeAllPairs(int threads) {
+    const CsrGraph& g = snapshot();
+    matrix.resize(g.nodeCount());
+    parallelFor(0, g.nodeCount(), [&](int s) { computeRow(g, s); }, threads);
+    matrixChanges.clear();
+    matrixValid = true;
+    matrixVersion = graphVersion;
+}
+
+// Row s can only change if some changed route (u, v) either now offers a
+// shorter way into u or v than the row records (a new or cheaper route), or
+// was tight in row s before, i.e. lay on one of its shortest paths (a removed
+// or dearer route). If no change does either, the old shortest-path tree is
+// still there at the same cost and nothing shorter appeared, so the row, and
+// its next hops, stand as they are.
+int AirportGraph::refreshAllPairs(int threads) {
+    if (!matrixValid || matrix.size() != airportCount()) {
+        computeAllPairs(threads);
+        return airportCount();
+    }
+    if (allPairsCurrent()) return 0;
+
+    struct Change { int u, v, before, after; };
+    vector<Change> changes;
+    for (const auto& entry : matrixChanges) {
+        int u = static_cast<int>(entry.first >> 32), v = static_cast<int>(entry.first & 0xffffffffu);
+        auto it = routes.find(entry.first);
+        int after = it == routes.end() ? INT_MAX : adj[it->second.u][it->second.posU].weight;
+        if (after != entry.second) changes.push_back({u, v, entry.second, after});
+    }
+
+    int n = matrix.size();
+    vector<int> rows;
+    for (int s = 0; s < n; ++s) {
+        const int32_t* dist = matrix.distanceRow(s);
+        for (const Change& c : changes) {
+            long long du = dist[c.u], dv = dist[c.v];
+            bool reachable = du != DistanceMatrix::UNREACHABLE || dv != DistanceMatrix::UNREACHABLE;
+            if (!reachable) continue;
+            bool affected;
+            if (c.after < c.before) {
+                affected = du + c.after < dv || dv + c.after < du;
+            } else {
+                affected = du + c.before == dv || dv + c.before == du;
+            }
+            if (affected) {
+                rows.push_back(s);
+                break;
+            }
+        }
+    }
+
+    const CsrGraph& g = snapshot();
+    parallelFor(0, static_cast<int>(rows.size()), [&](int i) { computeRow(g, rows[i]); }, threads);
+    matrixChanges.clear();
+    matrixVersion = graphVersion;
+    return static_cast<int>(rows.size());
+}
@@ -0,0 +1,80 @@
+#include "fms.h"
+#include "parallel_for.h"
+
+using namespace std;
+
+FlightIdMap::FlightIdMap(const FlightStore& store)
+    : store(store), table(), mask(0), count(0) {
+    rehash(64);
+}
+
+int FlightIdMap::find(FlightCode id) const {
+    for (size_t i = id.hash() & mask;; i = (i + 1) & mask) {
+        const Entry& e = table[i];
+        if (e.slot < 0) return -1;
+        if (e.code == id) return e.slot;
+    }
+}
+
+bool FlightIdMap::insert(int slot) {
+    if (static_cast<size_t>(count + 1) * 2 > table.size()) rehash(table.size() * 2);
+    FlightCode id = store[slot].flightID;
+    size_t i = id.hash() & mask;
+    for (;; i = (i + 1) & mask) {
+        const Entry& e = table[i];
+        if (e.slot < 0) break;
+        if (e.code == id) return false;
+    }
+    table[i] = {id, slot};
+    count++;
+    return true;
+}
+
+// Sorting by home bucket first turns the random probes of one insert per
+// slot into a walk through the table from front to back.
+int FlightIdMap::insertRange(int first, int last, int threads) {
+    if (last <= first) return 0;
+    reserve(count + (last - first));
+    vector<pair<size_t, int>> byBucket(last - first);
+    parallelFor(first, last, [&](int slot) { byBucket[slot - first] = {store[slot].flightID.hash() & mask, slot}; },
+                threads, 4096);
+    parallelSort(byBucket.begin(), byBucket.end(), less<pair<size_t, int>>(), threads);
+    int inserted = 0;
+    for (const auto& entry : byBucket) {
+        FlightCode id = store[entry.second].flightID;
+        size_t i = entry.first;
+        for (;; i = (i + 1) & mask) {
+            const Entry& e = table[i];
+            if (e.slot < 0 || e.code == id) break;
+        }
+        if (table[i].slot >= 0) continue;
+        table[i] = {id, entry.second};
+        inserted++;
+    }
+    count += inserted;
+    return inserted;
+}
+
+void FlightIdMap::reserve(int n) {
+    size_t capacity = table.size();
+    while (capacity < static_cast<size_t>(n) * 2) capacity *= 2;
+    if (capacity != table.size()) rehash(capacity);
+}
+
+void FlightIdMap::clear() {
+    table.assign(table.size(), Entry{FlightCode(), -1});
+    count = 0;
+}
+
+void FlightIdMap::rehash(size_t capacity) {
+    vector<Entry> old;
+    old.swap(table);
+    table.assign(capacity, Entry{FlightCode(), -1});
+    mask = capacity - 1;
+    for (const Entry& e : old) {
+        if (e.slot < 0) continue;
+        size_t i = e.code.hash() & mask;
+        while (table[i].slot >= 0) i = (i + 1) & mask;
+        table[i] = e;
+    }
+}
@@ -0,0 +1,202 @@
+#include "fms.h"
+#include <iostream>
+#include <algorithm>
+
+using namespace std;
+
+FlightIndexNode::FlightIndexNode(bool isLeaf)
+    : leaf(isLeaf), count(0), next(nullptr) {
+    fill(begin(children), end(children), nullptr);
+}
+
+FlightIndex::FlightIndex() : root(nullptr), count(0), levels(0) {}
+
+FlightIndex::~FlightIndex() {
+    clear();
+}
+
+void FlightIndex::clear() {
+    vector<FlightIndexNode*> stackNodes;
+    if (root) stackNodes.push_back(root);
+    while (!stackNodes.empty()) {
+        FlightIndexNode* node = stackNodes.back();
+        stackNodes.pop_back();
+        if (!node->leaf) {
+            for (int i = 0; i <= node->count; ++i) stackNodes.push_back(node->children[i]);
+        }
+        delete node;
+    }
+    root = nullptr;
+    count = 0;
+    levels = 0;
+}
+
+FlightIndexNode* FlightIndex::leftmostLeaf() const {
+    FlightIndexNode* node = root;
+    while (node && !node->leaf) node = node->children[0];
+    return node;
+}
+
+bool FlightIndex::insert(Flight* f) {
+    FlightCode id = f->flightID;
+    if (!root) {
+        root = new FlightIndexNode(true);
+        levels = 1;
+    }
+
+    // Descend to the leaf, remembering the path for splits on the way back up.
+    FlightIndexNode* path[64];
+    int slot[64];
+    int depth = 0;
+    FlightIndexNode* node = root;
+    while (!node->leaf) {
+        int i = static_cast<int>(upper_bound(node->keys, node->keys + node->count, id) - node->keys);
+        path[depth] = node;
+        slot[depth] = i;
+        depth++;
+        node = node->children[i];
+    }
+
+    int pos = static_cast<int>(lower_bound(node->keys, node->keys + node->count, id) - node->keys);
+    if (pos < node->count && node->keys[pos] == id) return false;
+    bool append = (pos == node->count && node->next == nullptr);
+    for (int i = node->count; i > pos; --i) {
+        node->keys[i] = node->keys[i - 1];
+        node->flights[i] = node->flights[i - 1];
+    }
+    node->keys[pos] = id;
+    node->flights[pos] = f;
+    node->count++;
+    count++;
+    if (node->count < ORDER) return true;
+
+    // Split the full leaf. Appends at the right edge keep the left leaf full
+    // so monotonic IDs pack leaves densely instead of leaving them half empty.
+    int keep = append ? ORDER - 1 : ORDER / 2;
+    FlightIndexNode* right = new FlightIndexNode(true);
+    for (int i = keep; i < node->count; ++i) {
+        right->keys[i - keep] = node->keys[i];
+        right->flights[i - keep] = node->flights[i];
+    }
+    right->count = node->count - keep;
+    node->count = keep;
+    right->next = node->next;
+    node->next = right;
+    FlightCode sep = right->keys[0];
+    FlightIndexNode* newChild = right;
+
+    while (depth > 0) {
+        depth--;
+        FlightIndexNode* parent = path[depth];
+        int at = slot[depth];
+        bool rightEdge = append && at == parent->count;
+        for (int i = parent->count; i > at; --i) {
+            parent->keys[i] = parent->keys[i - 1];
+            parent->children[i + 1] = parent->children[i];
+        }
+        parent->keys[at] = sep;
+        parent->children[at + 1] = newChild;
+        parent->count++;
+        if (parent->count < ORDER) return true;
+
+        int mid = rightEdge ? ORDER - 1 : ORDER / 2;
+        FlightIndexNode* sibling = new FlightIndexNode(false);
+        for (int i = mid + 1; i < parent->count; ++i) {
+            sibling->keys[i - mid - 1] = parent->keys[i];
+            sibling->children[i - mid - 1] = parent->children[i];
+        }
+        sibling->children[parent->count - mid - 1] = parent->children[parent->count];
+        sibling->count = parent->count - mid - 1;
+        sep = parent->keys[mid];
+        parent->count = mid;
+        newChild = sibling;
+    }
+
+    FlightIndexNode* newRoot = new FlightIndexNode(false);
+    newRoot->keys[0] = sep;
+    newRoot->children[0] = root;
+    newRoot->children[1] = newChild;
+    newRoot->count = 1;
+    root = newRoot;
+    levels++;
+    return true;
+}
+
+Flight* FlightIndex::search(FlightCode id) const {
+    FlightIndexNode* node = root;
+    if (!node) return nullptr;
+    while (!node->leaf) {
+        int i = static_cast<int>(upper_bound(node->keys, node->keys + node->count, id) - node->keys);
+        node = node->children[i];
+    }
+    int pos = static_cast<int>(lower_bound(node->keys, node->keys + node->count, id) - node->keys);
+    if (pos < node->count && node->keys[pos] == id) return node->flights[pos];
+    return nullptr;
+}
+
+void FlightIndex::displayInOrder() const {
+    for (FlightIndexNode* leaf = leftmostLeaf(); leaf; leaf = leaf->next) {
+        for (int i = 0; i < leaf->count; ++i) {
+            Flight* f = leaf->flights[i];
+            if (f->active) {
+                cout << f->flightID << ": " << f->source << " -> "
+                     << f->destination << ", Dist: " << f->distance
+                     << ", Seats: " << f->seats.load() << '\n';
+            }
+        }
+    }
+}
+
+// Flights already in ID order, as loadSnapshot passes them, skip the sort.
+void FlightIndex::bulkBuild(std::vector<Flight*> sorted) {
+    clear();
+    auto byId = [](const Flight* a, const Flight* b) { return a->flightID < b->flightID; };
+    if (!is_sorted(sorted.begin(), sorted.end(), byId)) sort(sorted.begin(), sorted.end(), byId);
+    sorted.erase(unique(sorted.begin(), sorted.end(), [](const Flight* a, const Flight* b) {
+        return a->flightID == b->flightID;
+    }), sorted.end());
+    if (sorted.empty()) return;
+
+    // Pack leaves to ORDER - 1 keys, then build each internal level from the
+    // first key of every child in the level below.
+    const int fill = ORDER - 1;
+    vector<FlightIndexNode*> level;
+    vector<FlightCode> firstKeys;
+    FlightIndexNode* prev = nullptr;
+    for (size_t i = 0; i < sorted.size(); i += fill) {
+        FlightIndexNode* leaf = new FlightIndexNode(true);
+        size_t end = min(sorted.size(), i + fill);
+        for (size_t j = i; j < end; ++j) {
+            leaf->keys[j - i] = sorted[j]->flightID;
+            leaf->flights[j - i] = sorted[j];
+        }
+        leaf->count = static_cast<int>(end - i);
+        if (prev) prev->next = leaf;
+        prev = leaf;
+        level.push_back(leaf);
+        firstKeys.push_back(leaf->keys[0]);
+    }
+    levels = 1;
+
+    while (level.size() > 1) {
+        vector<FlightIndexNode*> upper;
+        vector<FlightCode> upperKeys;
+        for (size_t i = 0; i < level.size(); i += ORDER) {
+            size_t end = min(level.size(), i + ORDER);
+            FlightIndexNode* node = new FlightIndexNode(false);
+            node->children[0] = level[i];
+            for (size_t j = i + 1; j < end; ++j) {
+                node->keys[j - i - 1] = firstKeys[j];
+                node->children[j - i] = level[j];
+            }
+            node->count = static_cast<int>(end - i - 1);
+            upper.push_back(node);
+            upperKeys.push_back(firstKeys[i]);
+        }
+        level.swap(upper);
+        firstKeys.swap(upperKeys);
+        levels++;
+    }
+    root = level[0];
+    count = static_cast<int>(sorted.size());
+}
@@ -0,0 +1,364 @@
+#include "fms.h"
+#include "mapped_file.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+using namespace std;
+
+namespace {
+// Pieces are cut this small at most so their line numbers fit an int.
+const size_t MAX_PIECE_BYTES = 64 << 20;
+const size_t MIN_PIECE_BYTES = 1 << 20;
+
+// A row that parsed. Airports are indices into its piece's airport list, so
+// rows stay small and each airport name is hashed once per piece.
+struct CsvRow {
+    FlightCode id;
+    int source;
+    int destination;
+    int distance;
+    int seats;
+    int line;  // within the piece, from 0
+    bool active;
+};
+
+struct LineError {
+    int line;
+    const char* reason;
+};
+
+// A run of whole lines of the file and what parsing it produced.
+struct CsvPiece {
+    const char* begin;
+    const char* end;
+    int lines;
+    vector<CsvRow> rows;
+    vector<LineError> errors;
+    vector<AirportCode> airports;  // in order of first appearance
+    unordered_map<AirportCode, int> airportIndex;
+};
+
+bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+void trim(const char*& first, const char*& last) {
+    while (first < last && isBlank(*first)) ++first;
+    while (last > first && isBlank(last[-1])) --last;
+}
+
+bool parseCount(const char* first, const char* last, int& out) {
+    auto result = from_chars(first, last, out);
+    return result.ec == errc() && result.ptr == last && out >= 0;
+}
+
+bool equalsLower(const char* first, const char* last, const char* word) {
+    size_t n = strlen(word);
+    if (static_cast<size_t>(last - first) != n) return false;
+    for (size_t i = 0; i < n; ++i) {
+        char c = first[i];
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        if (c != word[i]) return false;
+    }
+    return true;
+}
+
+int internAirport(CsvPiece& piece, AirportCode code) {
+    auto it = piece.airportIndex.emplace(code, static_cast<int>(piece.airports.size()));
+    if (it.second) piece.airports.push_back(code);
+    return it.first->second;
+}
+
+// Returns the reason the line is rejected, or nullptr if it parsed or is
+// blank.
+const char* parseLine(CsvPiece& piece, const char* first, const char* last, int line) {
+    trim(first, last);
+    if (first == last) return nullptr;
+    const char* fieldBegin[6];
+    const char* fieldEnd[6];
+    int fields = 0;
+    for (const char* start = first;;) {
+        if (fields == 6) return "expected 6 fields";
+        const char* comma = static_cast<const char*>(memchr(start, ',', last - start));
+        fieldBegin[fields] = start;
+        fieldEnd[fields] = comma ? comma : last;
+        trim(fieldBegin[fields], fieldEnd[fields]);
+        fields++;
+        if (!comma) break;
+        start = comma + 1;
+    }
+    if (fields != 6) return "expected 6 fields";
+
+    CsvRow row;
+    AirportCode source, destination;
+    if (!FlightCode::parse(fieldBegin[0], fieldEnd[0] - fieldBegin[0], row.id) || row.id.empty()) {
+        return "invalid flight ID";
+    }
+    if (!AirportCode::parse(fieldBegin[1], fieldEnd[1] - fieldBegin[1], source) || source.empty()) {
+        return "invalid source airport";
+    }
+    if (!AirportCode::parse(fieldBegin[2], fieldEnd[2] - fieldBegin[2], destination) || destination.empty()) {
+        return "invalid destination airport";
+    }
+    if (!parseCount(fieldBegin[3], fieldEnd[3], row.distance)) return "distance is not a non-negative integer";
+    if (!parseCount(fieldBegin[4], fieldEnd[4], row.seats)) return "seats is not a non-negative integer";
+    if (equalsLower(fieldBegin[5], fieldEnd[5], "true")) {
+        row.active = true;
+    } else if (equalsLower(fieldBegin[5], fieldEnd[5], "false")) {
+        row.active = false;
+    } else {
+        return "active is not True or False";
+    }
+    row.source = internAirport(piece, source);
+    row.destination = internAirport(piece, destination);
+    row.line = line;
+    piece.rows.push_back(row);
+    return nullptr;
+}
+
+void parsePiece(CsvPiece& piece) {
+    int line = 0;
+    for (const char* pos = piece.begin; pos < piece.end; ++line) {
+        const char* newline = static_cast<const char*>(memchr(pos, '\n', piece.end - pos));
+        const char* lineEnd = newline ? newline : piece.end;
+        const char* reason = parseLine(piece, pos, lineEnd, line);
+        if (reason) piece.errors.push_back({line, reason});
+        pos = newline ? newline + 1 : piece.end;
+    }
+    piece.lines = line;
+}
+
+// One active flight as a route of the graph: the airport pair, smaller index
+// in the high word, or NO_ROUTE.
+struct RouteArc {
+    uint64_t key;
+    int distance;
+};
+
+const uint64_t NO_ROUTE = ~0ull;
+
+// Fills image's CSR and route arrays from arcs sorted by key. Routes come in
+// (u, v) order, so appending each route to both its airports' lists leaves
+// every list sorted and the u < v arcs in CSR order in route order.
+void buildRoutes(GraphImage& image, const vector<RouteArc>& arcs) {
+    int n = static_cast<int>(image.airports.size());
+    CsrGraph& g = image.csr;
+    vector<int> degree(n, 0);
+    vector<size_t> firstArc;
+    size_t i = 0;
+    for (; i < arcs.size() && arcs[i].key != NO_ROUTE; ++i) {
+        if (i > 0 && arcs[i].key == arcs[i - 1].key) continue;
+        firstArc.push_back(i);
+        degree[arcs[i].key >> 32]++;
+        degree[arcs[i].key & 0xffffffffu]++;
+    }
+    size_t routeCount = firstArc.size();
+    firstArc.push_back(i);
+
+    g.offsets.assign(n + 1, 0);
+    for (int u = 0; u < n; ++u) g.offsets[u + 1] = g.offsets[u] + degree[u];
+    g.targets.assign(g.offsets[n], 0);
+    g.weights.assign(g.offsets[n], 0);
+    image.reversePositions.assign(routeCount, 0);
+    image.distanceCounts.assign(routeCount, 0);
+    image.distances.clear();
+    image.distances.reserve(firstArc.back());
+    vector<int> cursor(g.offsets.begin(), g.offsets.end() - 1);
+    for (size_t r = 0; r < routeCount; ++r) {
+        int u = static_cast<int>(arcs[firstArc[r]].key >> 32);
+        int v = static_cast<int>(arcs[firstArc[r]].key & 0xffffffffu);
+        int weight = INT_MAX;
+        for (size_t a = firstArc[r]; a < firstArc[r + 1]; ++a) {
+            weight = min(weight, arcs[a].distance);
+            image.distances.push_back(arcs[a].distance);
+        }
+        image.distanceCounts[r] = static_cast<int>(firstArc[r + 1] - firstArc[r]);
+        int forward = cursor[u]++, backward = cursor[v]++;
+        g.targets[forward] = v;
+        g.weights[forward] = weight;
+        g.targets[backward] = u;
+        g.weights[backward] = weight;
+        image.reversePositions[r] = backward - g.offsets[v];
+    }
+}
+}
+
+LoadReport FlightSystem::loadFlightsCsv(const std::string& path, int threads) {
+    LoadReport report = {false, 0, 0, {}};
+    MappedFile file(path);
+    if (!file.isOpen()) return report;
+    report.opened = true;
+    if (threads <= 0) threads = static_cast<int>(max(1u, thread::hardware_concurrency()));
+
+    // Cut the file into pieces of whole lines, a few per thread so uneven
+    // pieces balance, and parse them in parallel.
+    const char* data = file.data();
+    size_t size = file.size();
+    size_t pieceCount = min<size_t>(static_cast<size_t>(threads) * 4, max<size_t>(1, size / MIN_PIECE_BYTES));
+    pieceCount = max(pieceCount, (size + MAX_PIECE_BYTES - 1) / MAX_PIECE_BYTES);
+    vector<CsvPiece> pieces(pieceCount);
+    const char* cut = data;
+    for (size_t p = 0; p < pieceCount; ++p) {
+        pieces[p].begin = cut;
+        if (p + 1 == pieceCount) {
+            cut = data + size;
+        } else {
+            cut = max(cut, data + size * (p + 1) / pieceCount);
+            const char* newline = static_cast<const char*>(memchr(cut, '\n', data + size - cut));
+            cut = newline ? newline + 1 : data + size;
+        }
+        pieces[p].end = cut;
+    }
+    int pieceTotal = static_cast<int>(pieceCount);
+    parallelFor(0, pieceTotal, [&](int p) { parsePiece(pieces[p]); }, threads);
+
+    vector<long> lineBase(pieceCount + 1, 0), rowBase(pieceCount + 1, 0);
+    for (size_t p = 0; p < pieceCount; ++p) {
+        lineBase[p + 1] = lineBase[p] + pieces[p].lines;
+        rowBase[p + 1] = rowBase[p] + static_cast<long>(pieces[p].rows.size());
+    }
+    if (rowBase[pieceCount] > INT_MAX) {
+        report.rejected = rowBase[pieceCount];
+        report.errors.push_back({1, "too many rows"});
+        return report;
+    }
+    int rowCount = static_cast<int>(rowBase[pieceCount]);
+
+    // Sorting (ID, row) pairs finds IDs repeated in the file, keeping the
+    // first, and puts the new flights in B+ tree order.
+    vector<pair<FlightCode, int>> ids(rowCount);
+    parallelFor(0, pieceTotal, [&](int p) {
+        for (size_t k = 0; k < pieces[p].rows.size(); ++k) {
+            int row = static_cast<int>(rowBase[p] + k);
+            ids[row] = {pieces[p].rows[k].id, row};
+        }
+    }, threads);
+    parallelSort(ids.begin(), ids.end(), less<pair<FlightCode, int>>(), threads);
+    vector<const char*> rowError(rowCount, nullptr);
+    parallelFor(0, rowCount, [&](int i) {
+        if (i > 0 && ids[i].first == ids[i - 1].first) rowError[ids[i].second] = "duplicate flight ID";
+    }, threads, 4096);
+
+    uint64_t logged;
+    {
+        lock_guard<mutex> lock(bookingMutex);
+        if (rowCount > INT_MAX - flights.size()) {
+            report.rejected = rowCount;
+            report.errors.push_back({1, "too many rows"});
+            return report;
+        }
+        // Every add holds bookingMutex, so the IDs already loaded are checked
+        // against the same flights the rows are appended to.
+        parallelFor(0, rowCount, [&](int i) {
+            if (!rowError[ids[i].second] && flightIds.find(ids[i].first) >= 0) {
+                rowError[ids[i].second] = "flight ID already loaded";
+            }
+        }, threads, 4096);
+        lock_guard<shared_mutex> graphLock(graphMutex);
+        GraphImage image;
+        graph.saveImage(image);
+        unordered_map<AirportCode, int> airportIndex;
+        airportIndex.reserve(image.airports.size());
+        for (size_t i = 0; i < image.airports.size(); ++i) airportIndex.emplace(image.airports[i], static_cast<int>(i));
+
+        // Add the flights in file order, registering airports as addEdge
+        // would, and report errors in line order.
+        int oldCount = flights.size();
+        bool logging = wal.isOpen();
+        vector<int> slotOf(rowCount, -1);
+        vector<LineError> pieceErrors;
+        for (size_t p = 0; p < pieceCount; ++p) {
+            CsvPiece& piece = pieces[p];
+            pieceErrors = piece.errors;
+            vector<int> global(piece.airports.size(), -1);
+            for (size_t k = 0; k < piece.rows.size(); ++k) {
+                const CsvRow& r = piece.rows[k];
+                int row = static_cast<int>(rowBase[p] + k);
+                if (rowError[row]) {
+                    pieceErrors.push_back({r.line, rowError[row]});
+                    continue;
+                }
+                for (int a : {r.source, r.destination}) {
+                    if (global[a] >= 0) continue;
+                    auto it = airportIndex.emplace(piece.airports[a], static_cast<int>(image.airports.size()));
+                    if (it.second) {
+                        image.airports.push_back(piece.airports[a]);
+                        image.latitude.push_back(NAN);
+                        image.longitude.push_back(NAN);
+                    }
+                    global[a] = it.first->second;
+                }
+                slotOf[row] = flights.size();
+                Flight& f = flights.append();
+                f.flightID = r.id;
+                f.source = piece.airports[r.source];
+                f.destination = piece.airports[r.destination];
+                f.distance = r.distance;
+                f.seats.store(r.seats);
+                f.active = r.active;
+                if (logging) {
+                    wal.appendFlight(f);
+                    if (!f.active) wal.appendFlightState(f.flightID, false);
+                }
+            }
+            sort(pieceErrors.begin(), pieceErrors.end(), [](const LineError& a, const LineError& b) {
+                return a.line < b.line;
+            });
+            report.rejected += static_cast<long>(pieceErrors.size());
+            for (const LineError& e : pieceErrors) {
+                if (report.errors.size() == static_cast<size_t>(MAX_LOAD_ERRORS)) break;
+                report.errors.push_back({lineBase[p] + e.line + 1, e.reason});
+            }
+        }
+        int n = flights.size();
+        report.loaded = n - oldCount;
+        {
+            lock_guard<shared_mutex> idLock(flightIdMutex);
+            flightIds.insertRange(oldCount, n, threads);
+        }
+
+        vector<Flight*> byId;
+        byId.reserve(n);
+        if (oldCount == 0) {
+            for (const auto& id : ids) {
+                if (slotOf[id.second] >= 0) byId.push_back(&flights[slotOf[id.second]]);
+            }
+        } else {
+            vector<pair<FlightCode, int>> all(n);
+            parallelFor(0, n, [&](int i) { all[i] = {flights[i].flightID, i}; }, threads, 4096);
+            parallelSort(all.begin(), all.end(), less<pair<FlightCode, int>>(), threads);
+            for (const auto& id : all) byId.push_back(&flights[id.second]);
+        }
+        flightIndex.bulkBuild(std::move(byId));
+        searchIndex.build(flights, threads);
+
+        // Rebuild the graph from every active flight rather than patching in
+        // the new ones edge by edge.
+        vector<RouteArc> arcs(n);
+        parallelFor(0, n, [&](int i) {
+            const Flight& f = flights[i];
+            int u = airportIndex.find(f.source)->second, v = airportIndex.find(f.destination)->second;
+            if (!f.active || u == v) {
+                arcs[i] = {NO_ROUTE, 0};
+                return;
+            }
+            if (u > v) swap(u, v);
+            arcs[i] = {static_cast<uint64_t>(u) << 32 | static_cast<uint32_t>(v), f.distance};
+        }, threads, 4096);
+        parallelSort(arcs.begin(), arcs.end(), [](const RouteArc& a, const RouteArc& b) { return a.key < b.key; },
+                     threads);
+        buildRoutes(image, arcs);
+        graph.loadImage(std::move(image));
+
+        logged = wal.lastSequence();
+        lock_guard<mutex> searchLock(searchMutex);
+        for (AirportCode source : recentSearches.recent()) recentSearches.invalidate(source);
+    }
+    wal.commit(logged);
+    return report;
+}
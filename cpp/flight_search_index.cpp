@@ -0,0 +1,109 @@
+#include "fms.h"
+#include "parallel_for.h"
+#include <algorithm>
+
+using namespace std;
+
+FlightSearchIndex::FlightSearchIndex() : sources(), destinations(), routes() {}
+
+// Slots arrive in ascending order when flights are added, so the common case
+// is an append; re-scheduling an older flight inserts it back in place.
+template <class Key>
+void FlightSearchIndex::insertSlot(SlotLists<Key>& lists, const Key& key, int slot) {
+    vector<int>& slots = lists[key];
+    if (slots.empty() || slots.back() < slot) {
+        slots.push_back(slot);
+        return;
+    }
+    auto it = lower_bound(slots.begin(), slots.end(), slot);
+    if (*it != slot) slots.insert(it, slot);
+}
+
+template <class Key>
+void FlightSearchIndex::eraseSlot(SlotLists<Key>& lists, const Key& key, int slot) {
+    auto found = lists.find(key);
+    if (found == lists.end()) return;
+    vector<int>& slots = found->second;
+    auto it = lower_bound(slots.begin(), slots.end(), slot);
+    if (it != slots.end() && *it == slot) slots.erase(it);
+}
+
+template <class Key>
+SlotSpan FlightSearchIndex::lookup(const SlotLists<Key>& lists, const Key& key) {
+    auto found = lists.find(key);
+    if (found == lists.end()) return SlotSpan{nullptr, 0};
+    return SlotSpan{found->second.data(), found->second.size()};
+}
+
+void FlightSearchIndex::add(const Flight& f, int slot) {
+    insertSlot(sources, f.source, slot);
+    insertSlot(destinations, f.destination, slot);
+    insertSlot(routes, RouteKey{f.source, f.destination}, slot);
+}
+
+void FlightSearchIndex::remove(const Flight& f, int slot) {
+    eraseSlot(sources, f.source, slot);
+    eraseSlot(destinations, f.destination, slot);
+    eraseSlot(routes, RouteKey{f.source, f.destination}, slot);
+}
+
+// Sorting (key, slot) pairs leaves each key's slots together and ascending.
+template <class Key, class KeyOf>
+void FlightSearchIndex::buildLists(SlotLists<Key>& lists, const FlightStore& flights, const vector<int>& slots,
+                                   KeyOf keyOf, int threads) {
+    vector<pair<Key, int>> keyed(slots.size());
+    parallelFor(0, static_cast<int>(slots.size()), [&](int i) { keyed[i] = {keyOf(flights[slots[i]]), slots[i]}; },
+                threads, 4096);
+    parallelSort(keyed.begin(), keyed.end(), [](const pair<Key, int>& a, const pair<Key, int>& b) {
+        return a.first == b.first ? a.second < b.second : a.first < b.first;
+    }, threads);
+    size_t keys = 0;
+    for (size_t i = 0; i < keyed.size(); ++i) keys += i == 0 || !(keyed[i].first == keyed[i - 1].first);
+    lists.reserve(keys);
+    for (size_t begin = 0; begin < keyed.size();) {
+        size_t end = begin;
+        while (end < keyed.size() && keyed[end].first == keyed[begin].first) end++;
+        vector<int>& out = lists[keyed[begin].first];
+        out.reserve(end - begin);
+        for (size_t i = begin; i < end; ++i) out.push_back(keyed[i].second);
+        begin = end;
+    }
+}
+
+void FlightSearchIndex::build(const FlightStore& flights, int threads) {
+    clear();
+    vector<int> slots;
+    slots.reserve(flights.size());
+    for (int i = 0; i < flights.size(); ++i) {
+        if (flights[i].active) slots.push_back(i);
+    }
+    // Filling each map is serial, so the three are built side by side.
+    parallelFor(0, 3, [&](int list) {
+        if (list == 0) {
+            buildLists(sources, flights, slots, [](const Flight& f) { return f.source; }, threads);
+        } else if (list == 1) {
+            buildLists(destinations, flights, slots, [](const Flight& f) { return f.destination; }, threads);
+        } else {
+            buildLists(routes, flights, slots, [](const Flight& f) { return RouteKey{f.source, f.destination}; },
+                       threads);
+        }
+    }, threads);
+}
+
+void FlightSearchIndex::clear() {
+    sources.clear();
+    destinations.clear();
+    routes.clear();
+}
+
+SlotSpan FlightSearchIndex::bySource(AirportCode source) const {
+    return lookup(sources, source);
+}
+
+SlotSpan FlightSearchIndex::byDestination(AirportCode destination) const {
+    return lookup(destinations, destination);
+}
+
+SlotSpan FlightSearchIndex::byRoute(AirportCode source, AirportCode destination) const {
+    return lookup(routes, RouteKey{source, destination});
+}
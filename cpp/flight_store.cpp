@@ -0,0 +1,35 @@
+#include "fms.h"
+#include <new>
+
+using namespace std;
+
+// Reserving only allocates address space; pages are touched as chunks are
+// added.
+FlightStore::FlightStore() : chunks(), count(0) {
+    chunks.reserve(MAX_CHUNKS);
+}
+
+FlightStore::~FlightStore() {
+    clear();
+}
+
+Flight& FlightStore::append() {
+    int offset = count & (CHUNK_SIZE - 1);
+    if (offset == 0 && (count >> CHUNK_SHIFT) == static_cast<int>(chunks.size())) {
+        chunks.push_back(static_cast<Flight*>(::operator new(sizeof(Flight) * CHUNK_SIZE)));
+    }
+    Flight* slot = new (&chunks[count >> CHUNK_SHIFT][offset]) Flight();
+    count++;
+    return *slot;
+}
+
+void FlightStore::clear() {
+    for (int i = 0; i < count; ++i) (*this)[i].~Flight();
+    for (Flight* chunk : chunks) ::operator delete(chunk);
+    chunks.clear();
+    count = 0;
+}
+
+size_t FlightStore::memoryBytes() const {
+    return chunks.size() * (sizeof(Flight) * CHUNK_SIZE + sizeof(Flight*));
+}
@@ -2,10 +2,22 @@
 
 #include <string>
 #include <vector>
-#include <stack>
 #include <queue>
 #include <unordered_map>
 #include <utility>
+#include <cstdint>
+#include <climits>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <tuple>
+#include "codes.h"
+#include "mpsc_queue.h"
 
 struct BookingNode {
     int bookingId;
@@ -15,17 +27,107 @@ struct BookingNode {
 };
 
 struct Flight {
-    std::string flightID;
-    std::string source;
-    std::string destination;
+    FlightCode flightID;
+    AirportCode source;
+    AirportCode destination;
     int distance;
-    int seats;
-    bool active;
-    BookingNode* bookingHead;
+    std::atomic<int> seats;  // changed only through SeatInventory
+    // Read without bookingMutex by the booking entry points as an early
+    // reject; confirmBooking checks it again under the lock.
+    std::atomic<bool> active;
+    // Scheduled times in seconds since the Unix epoch; both 0 for a flight
+    // without a timetable slot. Only flights arriving after they depart take
+    // part in connection search.
+    int64_t departureTime;
+    int64_t arrivalTime;
     Flight();
+    Flight(const Flight& other);
+    Flight& operator=(const Flight& other);
 };
 
-const int MAX_FLIGHTS = 100;
+struct BookingRecord {
+    int bookingId;
+    std::string passengerName;
+};
+
+// Bookings for every flight. Each flight owns a contiguous array of records,
+// and a global table indexed by booking ID gives the (flight, slot) of every
+// live booking, so lookup and cancellation are O(1). Cancelling leaves a
+// tombstone (bookingId == 0); a flight's array is compacted once tombstones
+// outnumber live records.
+class BookingTable {
+public:
+    BookingTable();
+
+    int add(int flightIndex, const std::string& passengerName);
+    bool cancel(int flightIndex, int bookingId);
+    int flightOf(int bookingId) const;
+    int liveCount(int flightIndex) const;
+    void reserve(int flightIndex, int extra);
+    int nextBookingId() const { return nextId; }
+    void clear();
+
+    // Bulk restore of saved bookings: reset() empties the table, sized for
+    // flightCount flights and booking IDs below nextBookingId, and restore()
+    // hands a flight its live bookings under their original IDs. restore()
+    // calls for different flights may run concurrently.
+    void reset(int flightCount, int nextBookingId);
+    void restore(int flightIndex, std::vector<BookingRecord> records);
+
+    // Calls fn(const BookingRecord&) for each live booking in booking order.
+    template <class Fn>
+    void forEach(int flightIndex, Fn fn) const {
+        if (flightIndex < 0 || flightIndex >= static_cast<int>(flights.size())) return;
+        for (const BookingRecord& r : flights[flightIndex].records) {
+            if (r.bookingId != 0) fn(r);
+        }
+    }
+
+private:
+    struct FlightBookings {
+        std::vector<BookingRecord> records;
+        int live = 0;
+    };
+    struct Location {
+        int flight;
+        int slot;
+    };
+
+    std::vector<FlightBookings> flights;
+    std::vector<Location> locations;
+    int nextId;
+
+    void compact(int flightIndex);
+};
+
+// Append-only flight storage split into fixed-size chunks. Chunks are never
+// reallocated, so Flight* held by FlightBST and indices held by bookingQueue
+// stay valid while the store grows. The chunk table is reserved for every
+// chunk an int slot can reach, so it never moves either and slots already
+// handed out can be read while another thread appends.
+class FlightStore {
+public:
+    static const int CHUNK_SHIFT = 12;
+    static const int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+    static const int MAX_CHUNKS = (INT_MAX >> CHUNK_SHIFT) + 1;
+
+    FlightStore();
+    ~FlightStore();
+    FlightStore(const FlightStore&) = delete;
+    FlightStore& operator=(const FlightStore&) = delete;
+
+    Flight& append();
+    void clear();
+    int size() const { return count; }
+    size_t memoryBytes() const;
+
+    Flight& operator[](int i) { return chunks[i >> CHUNK_SHIFT][i & (CHUNK_SIZE - 1)]; }
+    const Flight& operator[](int i) const { return chunks[i >> CHUNK_SHIFT][i & (CHUNK_SIZE - 1)]; }
+
+private:
+    std::vector<Flight*> chunks;
+    int count;
+};
 
 struct FlightBSTNode {
     Flight* flightPtr;
@@ -39,48 +141,861 @@ private:
     FlightBSTNode* root;
     FlightBSTNode* insertRec(FlightBSTNode* node, Flight* f);
     void inorderRec(FlightBSTNode* node);
-    Flight* searchRec(FlightBSTNode* node, const std::string& id);
+    Flight* searchRec(FlightBSTNode* node, FlightCode id);
 public:
     FlightBST();
     ~FlightBST();
     void insert(Flight* f);
-    Flight* search(const std::string& id);
+    Flight* search(FlightCode id);
     void displayInOrder();
 };
 
+// Lock-free seat accounting on top of Flight::seats. Reservations are CAS
+// loops on the flight's own counter, so readers never block and unrelated
+// flights never contend. Holds (seats reserved for a limited time) live in
+// striped tables keyed by flight slot; an expired hold gives its seats back
+// when the stripe is swept, which reserve() does before reporting sold out.
+class SeatInventory {
+public:
+    static const int STRIPES = 64;
+
+    explicit SeatInventory(FlightStore& flights);
+
+    int available(int slot) const;
+    bool reserve(int slot, int count);
+    int reserveUpTo(int slot, int count);
+    void release(int slot, int count);
+
+    // Returns a hold ID, or 0 if the seats are not available.
+    uint64_t placeHold(int slot, int count, int ttlMillis);
+    // Removes the hold. Confirming keeps its seats reserved; releasing returns
+    // them. Both return the hold's seat count, or 0 if it was unknown/expired.
+    // Confirming a hold of other than expectedCount seats (-1: any) returns 0
+    // and leaves it in place.
+    int confirmHold(uint64_t holdId, int expectedCount = -1, int* slot = nullptr);
+    int releaseHold(uint64_t holdId);
+    int expireHolds();
+    int activeHolds() const;
+    // Drops every hold without giving its seats back, for when the seat
+    // counts themselves are being replaced.
+    void clear();
+    // Each flight's available seats with its holds' seats given back, read
+    // under its stripe's lock so no hold is placed or released meanwhile.
+    std::vector<int> unheldSeats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Hold {
+        int slot;
+        int count;
+        Clock::time_point expires;
+    };
+    struct alignas(64) Stripe {
+        std::mutex lock;
+        std::unordered_map<uint64_t, Hold> holds;
+        std::atomic<int> size{0};
+    };
+
+    FlightStore& flights;
+    std::unique_ptr<Stripe[]> stripes;
+    std::atomic<uint64_t> nextHold;
+
+    bool tryReserve(int slot, int count);
+    int sweep(Stripe& stripe, Clock::time_point now);
+    int sweepLocked(Stripe& stripe, Clock::time_point now);
+    int takeHold(uint64_t holdId, int* slot, bool giveBack, int expectedCount);
+};
+
+// Open-addressing (linear probing) hash map from flightID to FlightStore slot.
+// Entries hold the packed FlightCode next to the slot, so a probe compares
+// integers and never touches the store.
+class FlightIdMap {
+public:
+    explicit FlightIdMap(const FlightStore& store);
+
+    int find(FlightCode id) const;
+    bool insert(int slot);
+    // Inserts slots [first, last) on `threads` threads, skipping IDs already
+    // present, and returns how many were inserted.
+    int insertRange(int first, int last, int threads = 0);
+    void reserve(int n);
+    void clear();
+    int size() const { return count; }
+
+private:
+    struct Entry {
+        FlightCode code;
+        int32_t slot;
+    };
+
+    const FlightStore& store;
+    std::vector<Entry> table;
+    size_t mask;
+    int count;
+
+    void rehash(size_t capacity);
+};
+
+// Read-only view of a run of FlightStore slots owned by FlightSearchIndex.
+// Valid until the next flight is added, cancelled or scheduled.
+struct SlotSpan {
+    const int* first;
+    size_t count;
+
+    const int* begin() const { return first; }
+    const int* end() const { return first + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    int operator[](size_t i) const { return first[i]; }
+};
+
+struct RouteKey {
+    AirportCode source;
+    AirportCode destination;
+
+    friend bool operator==(const RouteKey& a, const RouteKey& b) {
+        return a.source == b.source && a.destination == b.destination;
+    }
+    friend bool operator<(const RouteKey& a, const RouteKey& b) {
+        return a.source == b.source ? a.destination < b.destination : a.source < b.source;
+    }
+};
+
+namespace std {
+template <>
+struct hash<RouteKey> {
+    size_t operator()(const RouteKey& key) const {
+        return static_cast<size_t>(key.source.hash() * 31 ^ key.destination.hash());
+    }
+};
+}
+
+// Secondary indexes of active flights by source, destination and
+// (source, destination). Each key maps to its slots in ascending order, so a
+// query is one hash lookup returning a contiguous span, listed in the same
+// order as a scan of the store.
+class FlightSearchIndex {
+public:
+    FlightSearchIndex();
+
+    void add(const Flight& f, int slot);
+    void remove(const Flight& f, int slot);
+    void clear();
+    // Replaces the contents with every active flight in the store: slots are
+    // grouped per key by sorting (on `threads` workers, 0 = all cores) rather
+    // than one hash lookup each, and each list is allocated once.
+    void build(const FlightStore& flights, int threads = 0);
+
+    SlotSpan bySource(AirportCode source) const;
+    SlotSpan byDestination(AirportCode destination) const;
+    SlotSpan byRoute(AirportCode source, AirportCode destination) const;
+
+private:
+    template <class Key>
+    using SlotLists = std::unordered_map<Key, std::vector<int>>;
+
+    SlotLists<AirportCode> sources;
+    SlotLists<AirportCode> destinations;
+    SlotLists<RouteKey> routes;
+
+    template <class Key>
+    static void insertSlot(SlotLists<Key>& lists, const Key& key, int slot);
+    template <class Key>
+    static void eraseSlot(SlotLists<Key>& lists, const Key& key, int slot);
+    template <class Key>
+    static SlotSpan lookup(const SlotLists<Key>& lists, const Key& key);
+    template <class Key, class KeyOf>
+    static void buildLists(SlotLists<Key>& lists, const FlightStore& flights, const std::vector<int>& slots,
+                           KeyOf keyOf, int threads);
+};
+
+// Memoized answer to a source search: the matching slots and a copy of each
+// flight, taken when the search last missed the cache.
+struct SearchResult {
+    std::vector<int> slots;
+    std::vector<Flight> flights;
+};
+
+// Bounded history of searched sources. Each source has a single entry
+// carrying its query count, and entries are kept most-recent-first in an
+// intrusive list over a fixed array, so the history never grows past its
+// capacity and the least recently searched source is the one evicted. An
+// entry can also hold the last result for its source until invalidate().
+class SearchHistory {
+public:
+    static const int DEFAULT_CAPACITY = 64;
+
+    explicit SearchHistory(int capacity = DEFAULT_CAPACITY);
+
+    void record(AirportCode source);
+    int count(AirportCode source) const;
+    std::vector<AirportCode> recent() const;
+    std::vector<std::pair<AirportCode, int>> top(int k) const;
+
+    // Only sources currently in the history can hold a cached result.
+    const SearchResult* cached(AirportCode source) const;
+    void store(AirportCode source, SearchResult result);
+    void invalidate(AirportCode source);
+
+    void clear();
+    int size() const { return static_cast<int>(slots.size()); }
+    int capacity() const { return static_cast<int>(entries.size()); }
+
+private:
+    struct Entry {
+        AirportCode source;
+        int count;
+        int prev;
+        int next;
+        bool hasResult;
+        SearchResult result;
+    };
+
+    std::vector<Entry> entries;
+    std::unordered_map<AirportCode, int> slots;
+    int head;
+    int tail;
+
+    void unlink(int i);
+    void pushFront(int i);
+};
+
+// B+ tree on flightID. Keys are stored inline in wide nodes, leaves are
+// chained for in-order scans, and insert/search/display are iterative, so
+// monotonic IDs ("F101", "F102", ...) neither degrade lookups nor deepen the
+// call stack.
+struct FlightIndexNode;
+
+class FlightIndex {
+public:
+    static const int ORDER = 32;
+
+    FlightIndex();
+    ~FlightIndex();
+    FlightIndex(const FlightIndex&) = delete;
+    FlightIndex& operator=(const FlightIndex&) = delete;
+
+    bool insert(Flight* f);
+    Flight* search(FlightCode id) const;
+    void displayInOrder() const;
+    void bulkBuild(std::vector<Flight*> sorted);
+    void clear();
+    int size() const { return count; }
+    int height() const { return levels; }
+
+private:
+    FlightIndexNode* root;
+    int count;
+    int levels;
+
+    FlightIndexNode* leftmostLeaf() const;
+};
+
+struct FlightIndexNode {
+    bool leaf;
+    int count;
+    FlightCode keys[FlightIndex::ORDER];
+    union {
+        FlightIndexNode* children[FlightIndex::ORDER + 1];
+        Flight* flights[FlightIndex::ORDER];
+    };
+    FlightIndexNode* next;
+    FlightIndexNode(bool isLeaf);
+};
+
+// Frozen compressed-sparse-row copy of the airport adjacency: the neighbours
+// of airport u are targets[offsets[u]] .. targets[offsets[u + 1] - 1], with
+// the matching distances in weights.
+struct CsrGraph {
+    std::vector<int> offsets;
+    std::vector<int> targets;
+    std::vector<int> weights;
+
+    int nodeCount() const { return offsets.empty() ? 0 : static_cast<int>(offsets.size()) - 1; }
+    int begin(int u) const { return offsets[u]; }
+    int end(int u) const { return offsets[u + 1]; }
+};
+
+// Monotone priority queue (radix heap) for Dijkstra-style searches, with the
+// push/top/pop shape of std::priority_queue over (key, value) pairs. Keys are
+// non-negative and a pushed key may not be below the last popped one; an entry
+// sits in the bucket of the highest bit where it differs from that key and
+// only ever moves to lower buckets. clear() keeps the buckets' capacity.
+class RadixHeap {
+public:
+    RadixHeap();
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    void clear();
+    void push(int key, int value);
+    const std::pair<int, int>& top();  // redistributes a bucket if needed
+    void pop();
+
+private:
+    void pull();
+
+    std::vector<std::pair<int, int>> buckets[33];
+    uint32_t last;
+    size_t count;
+};
+
+// Distance and parent per airport, cleared in O(1) by bumping an epoch: a
+// label only counts if its stamp matches the current epoch.
+class SearchLabels {
+public:
+    SearchLabels();
+
+    void reset(int n);  // every distance INT_MAX, every parent -1
+    int dist(int v) const { return labels[v].stamp == epoch ? labels[v].dist : INT_MAX; }
+    int parent(int v) const { return labels[v].stamp == epoch ? labels[v].parent : -1; }
+    void set(int v, int dist, int parent) { labels[v] = {epoch, dist, parent}; }
+    size_t memoryBytes() const { return labels.capacity() * sizeof(Label); }
+
+private:
+    struct Label {
+        uint32_t stamp;
+        int dist;
+        int parent;
+    };
+    std::vector<Label> labels;
+    uint32_t epoch;
+};
+
+// Scratch space for one search at a time: labels and a heap per search
+// direction, a cache of A* potentials (in potential.dist), buffers for
+// assembling paths, and the stack and frontiers of the plain traversals.
+// Everything grows to the largest graph seen and is then reused, so searches
+// on a warmed-up context do not allocate. local() gives each thread its own.
+struct DijkstraContext {
+    SearchLabels labels[2];
+    RadixHeap heap[2];
+    SearchLabels potential;
+    std::vector<int> path;
+    std::vector<int> upPath;
+    std::vector<std::pair<int, int>> unpackStack;
+    std::vector<std::pair<int, int>> dfsStack;  // (airport, next arc)
+    std::vector<int> frontier[2];
+
+    static DijkstraContext& local();
+};
+
+// Row-major n x n tables of shortest distances and next hops (the first
+// airport after the source on a shortest path; -1 for the source itself and
+// for unreachable airports, whose distance is UNREACHABLE). Each row is
+// padded to a whole number of 64-byte cache lines on 64-byte aligned storage,
+// so parallel workers filling different rows never share a line. The storage
+// is reference counted, which lets the Python module hand it to NumPy without
+// copying and keep it alive after the matrix is resized.
+class DistanceMatrix {
+public:
+    static const int32_t UNREACHABLE = INT32_MAX;
+    static const int ROW_ALIGN = 16;  // int32 entries per cache line
+
+    DistanceMatrix();
+
+    void resize(int n);  // contents are unspecified afterwards
+    int size() const { return n; }
+    int stride() const { return rowStride; }
+    size_t memoryBytes() const { return 2 * static_cast<size_t>(n) * rowStride * sizeof(int32_t); }
+
+    int32_t* distanceRow(int i) { return dist.get() + static_cast<size_t>(i) * rowStride; }
+    int32_t* nextHopRow(int i) { return next.get() + static_cast<size_t>(i) * rowStride; }
+    const int32_t* distanceRow(int i) const { return dist.get() + static_cast<size_t>(i) * rowStride; }
+    const int32_t* nextHopRow(int i) const { return next.get() + static_cast<size_t>(i) * rowStride; }
+    int32_t distance(int i, int j) const { return distanceRow(i)[j]; }
+    int32_t nextHop(int i, int j) const { return nextHopRow(i)[j]; }
+
+    std::shared_ptr<int32_t> distanceStorage() const { return dist; }
+    std::shared_ptr<int32_t> nextHopStorage() const { return next; }
+
+private:
+    std::shared_ptr<int32_t> dist;
+    std::shared_ptr<int32_t> next;
+    int n;
+    int rowStride;
+};
+
+// Contraction Hierarchies over a CsrGraph snapshot. Airports are contracted
+// in order of edge difference; shortcuts replace paths through each
+// contracted airport unless a bounded witness search finds another path that
+// is no longer. A query is a bidirectional Dijkstra that only climbs to
+// higher-ranked airports, and shortcuts are unpacked through their middle
+// airport to recover the full path.
+class ContractionHierarchy {
+public:
+    ContractionHierarchy();
+
+    void build(const CsrGraph& g);
+    void clear();
+    bool empty() const { return rank.empty(); }
+    int shortcutCount() const { return shortcuts; }
+    size_t memoryBytes() const;
+
+    // Distance between airport indices (INT_MAX if unreachable); path gets
+    // the airports along a shortest route, both ends included.
+    int query(int s, int t, std::vector<int>& path, int* settled = nullptr) const;
+
+private:
+    // Upward edges in CSR form: the edges of airport u lead to higher-ranked
+    // airports; middle is the airport a shortcut bypasses, or -1.
+    std::vector<int> rank;
+    std::vector<int> offsets;
+    std::vector<int> targets;
+    std::vector<int> weights;
+    std::vector<int> middles;
+    int shortcuts;
+
+    int middleOf(int a, int b) const;
+    void unpack(int a, int b, std::vector<std::pair<int, int>>& pending, std::vector<int>& path) const;
+};
+
+// Point-to-point search strategies for AirportGraph::shortestPath.
+//   ROUTE_FULL           settle every reachable airport (the old dijkstra_path)
+//   ROUTE_EARLY_EXIT     stop as soon as the destination is settled
+//   ROUTE_BIDIRECTIONAL  search from both ends until the frontiers meet
+//   ROUTE_ASTAR          goal-directed by great-circle distance; needs
+//                        coordinates for every airport
+//   ROUTE_AUTO           A* when every airport has coordinates, else
+//                        bidirectional
+//   ROUTE_CONTRACTED     the contraction hierarchy if it matches the current
+//                        graph, else ROUTE_AUTO
+enum RouteMode {
+    ROUTE_FULL,
+    ROUTE_EARLY_EXIT,
+    ROUTE_BIDIRECTIONAL,
+    ROUTE_ASTAR,
+    ROUTE_AUTO,
+    ROUTE_CONTRACTED
+};
+
+// One route through the network: its total distance and the airports on it.
+struct Itinerary {
+    int distance;
+    std::vector<AirportCode> airports;
+};
+
+// One route of a spanning forest.
+struct SpanningEdge {
+    AirportCode from;
+    AirportCode to;
+    int distance;
+};
+
+// A minimum spanning forest: one tree per connected part of the network.
+struct SpanningForest {
+    long long weight;
+    std::vector<SpanningEdge> edges;
+};
+
+struct RouteStats {
+    RouteMode mode;  // strategy actually used
+    int settled;     // airports popped and expanded
+};
+
+// AirportGraph state as flat arrays, for saving and bulk loading: airports
+// in index order with their coordinates (radians, NaN if unknown), the CSR
+// of their routes, and for every route, taken as the arc u -> v with u < v in
+// CSR order, the position of u in v's list and its active flights'
+// distances (distanceCounts per route, concatenated in distances).
+struct GraphImage {
+    std::vector<AirportCode> airports;
+    std::vector<double> latitude;
+    std::vector<double> longitude;
+    CsrGraph csr;
+    std::vector<int> reversePositions;
+    std::vector<int> distanceCounts;
+    std::vector<int> distances;
+};
+
+// Undirected route graph over airports. Each airport pair has at most one
+// edge, weighted by the shortest of the active flights between them; addEdge
+// and removeEdge register and withdraw one flight's distance. A weight change
+// is patched in place (in the snapshot too), so only adding or dropping a
+// whole route invalidates the snapshot. Flights from an airport to itself
+// register the airport but never shorten a path, so they get no edge.
 class AirportGraph {
 public:
     AirportGraph();
-    int getAirportIndex(const std::string& name);
-    void addEdge(const std::string& src, const std::string& dest, int dist);
-    void DFS(const std::string& start);
-    void BFS(const std::string& start);
-    void dijkstra(const std::string& source, const std::string& dest);
-    void primMST(const std::string& start);
+    int getAirportIndex(AirportCode name);
+    void addEdge(AirportCode src, AirportCode dest, int dist);
+    bool removeEdge(AirportCode src, AirportCode dest, int dist);
+    int airportCount() const { return static_cast<int>(indexToAirport.size()); }
+    int routeCount() const { return static_cast<int>(routes.size()); }
+
+    // saveImage brings the snapshot up to date and copies the graph out.
+    // loadImage replaces the graph with an image without replaying addEdge;
+    // it returns false, changing nothing, if the image is inconsistent.
+    void saveImage(GraphImage& image);
+    bool loadImage(GraphImage&& image);
+
+    // Traversals read this snapshot; it is rebuilt on first use after addEdge.
+    const CsrGraph& snapshot();
+
+    // Bumped whenever an airport, route or route weight changes.
+    uint64_t version() const { return graphVersion; }
+
+    // The hierarchy is built on request and is only used while version()
+    // still matches the graph it was built from.
+    void buildHierarchy();
+    bool hierarchyCurrent() const { return !hierarchy.empty() && hierarchyVersion == graphVersion; }
+    const ContractionHierarchy& contractionHierarchy() const { return hierarchy; }
+
+    // All-pairs distances and next hops: one Dijkstra per source airport,
+    // spread over `threads` workers (0 = all cores). refreshAllPairs only
+    // recomputes the rows a route change since the last computation can have
+    // affected (all of them if airports were added) and returns how many.
+    void computeAllPairs(int threads = 0);
+    int refreshAllPairs(int threads = 0);
+    bool allPairsCurrent() const { return matrixValid && matrixVersion == graphVersion; }
+    const DistanceMatrix& allPairs() const { return matrix; }
+    AirportCode airportAt(int index) const { return indexToAirport[index]; }
+
+    // Iterative traversals from start that fill order (cleared first) with
+    // airport indices in visit order; depthFirst matches the recursive
+    // preorder. maxDepth limits the number of routes from start (-1: no
+    // limit; for depthFirst, depth in its tree). visit, if given, sees each
+    // airport and its depth as it is visited and can return false to stop
+    // there. Both return how many airports were visited, 0 if start is
+    // unknown, and allocate nothing once order and the thread's
+    // DijkstraContext have grown to the graph.
+    using TraversalVisitor = std::function<bool(int airport, int depth)>;
+    int depthFirst(AirportCode start, std::vector<int>& order, int maxDepth = -1,
+                   const TraversalVisitor& visit = nullptr);
+    int breadthFirst(AirportCode start, std::vector<int>& order, int maxDepth = -1,
+                     const TraversalVisitor& visit = nullptr);
+    // Direction-optimizing BFS for reachability: expands the frontier top-down
+    // while it is small and switches to bottom-up steps, where each unreached
+    // airport looks for a neighbour in the frontier, once the frontier's arcs
+    // outnumber a fraction of the unexplored ones. depth gets the number of
+    // routes from start per airport (-1 if unreached); returns how many
+    // airports were reached.
+    int reachableFrom(AirportCode start, std::vector<int>& depth, int maxDepth = -1);
+
+    void DFS(AirportCode start);
+    void BFS(AirportCode start);
+    void dijkstra(AirportCode source, AirportCode dest);
+    void primMST(AirportCode start);
     void kruskalMST();
 
-    std::pair<int, std::vector<std::string>> dijkstra_path(const std::string& source, const std::string& dest);
+    // Minimum spanning forests as data (primTree covers only start's part of
+    // the network, and is empty if start is unknown). Equal distances are
+    // ordered by airport index, which makes the forest unique:
+    // kruskalForest and boruvkaForest return the same edges, lower airport
+    // index first and by ascending distance. kruskalForest sorts the routes
+    // on `threads` workers (0 = all cores); boruvkaForest runs every phase
+    // on them, each component picking its cheapest route out and the picks
+    // merging through a lock-free union-find.
+    SpanningForest primTree(AirportCode start);
+    SpanningForest kruskalForest(int threads = 0);
+    SpanningForest boruvkaForest(int threads = 0);
+
+    // Which airports the routes connect, kept up to date by addEdge at
+    // near-constant cost per new route. Dropping a route can split a
+    // component, which a union-find cannot undo, so removeEdge only marks the
+    // structure stale and the next query rebuilds it from the routes in one
+    // pass: any number of cancellations between queries cost one rebuild.
+    // Unknown airports are connected to nothing and in no component.
+    bool connected(AirportCode a, AirportCode b);
+    int componentSize(AirportCode airport);
+    int componentCount();
+    // Every component's airports in index order; components ordered by their
+    // first airport.
+    std::vector<std::vector<AirportCode>> components();
+
+    std::pair<int, std::vector<AirportCode>> dijkstra_path(AirportCode source, AirportCode dest);
+
+    // Latitude/longitude in degrees. A* turns great-circle distance into a
+    // lower bound by scaling it with the smallest distance/great-circle ratio
+    // over all routes, so the heuristic stays admissible whatever unit the
+    // flight distances use.
+    bool setAirportCoordinates(AirportCode name, double latitude, double longitude);
+    bool hasAllCoordinates() const;
+
+    // Same (distance, path) as dijkstra_path, or (INT_MAX, {}) if unreachable.
+    std::pair<int, std::vector<AirportCode>> shortestPath(AirportCode source, AirportCode dest,
+                                                          RouteMode mode = ROUTE_AUTO,
+                                                          RouteStats* stats = nullptr);
+
+    // shortestPath without the lazy upkeep: prepareQueries() brings the
+    // snapshot and the A* heuristic up to date, after which findRoute may run
+    // on any number of threads at once until the graph is next modified.
+    // Searches use the calling thread's DijkstraContext.
+    void prepareQueries();
+    bool queriesPrepared() const { return !csrDirty && (!heuristicDirty || !hasAllCoordinates()); }
+    std::pair<int, std::vector<AirportCode>> findRoute(AirportCode source, AirportCode dest,
+                                                       RouteMode mode = ROUTE_AUTO,
+                                                       RouteStats* stats = nullptr) const;
+
+    // Up to k loopless routes from source to dest in order of distance
+    // (Yen's algorithm), each at most maxLegs routes long (0 = no limit) and
+    // avoiding the excluded airports. findItineraries is the version for a
+    // prepared graph, as findRoute is for shortestPath.
+    std::vector<Itinerary> kShortestPaths(AirportCode source, AirportCode dest, int k, int maxLegs = 0,
+                                          const std::vector<AirportCode>& excluded = {});
+    std::vector<Itinerary> findItineraries(AirportCode source, AirportCode dest, int k, int maxLegs = 0,
+                                           const std::vector<AirportCode>& excluded = {}) const;
 
 private:
-    struct Edge { int u, v, w; };
+    struct Arc {
+        int to;
+        int weight;
+    };
+    // Both directions of one airport pair: where each arc sits in adj, and
+    // the distances of the active flights using it.
+    struct Route {
+        int u, v;
+        int posU, posV;
+        std::vector<int> distances;
+    };
+    // Union by size, so the size of a set is kept at its root.
     struct DSU {
-        std::vector<int> parent, rnk;
+        std::vector<int> parent, size;
         DSU(int n = 0);
         void init(int n);
+        int add();
         int find(int x);
         bool unite(int a, int b);
     };
 
-    std::unordered_map<std::string,int> airportIndex;
-    std::vector<std::string> indexToAirport;
-    std::vector<std::vector<std::pair<int,int>>> adj;
+    std::unordered_map<AirportCode,int> airportIndex;
+    std::vector<AirportCode> indexToAirport;
+    std::vector<std::vector<Arc>> adj;
+    std::unordered_map<uint64_t, Route> routes;
+    CsrGraph csr;
+    bool csrDirty;
+    std::vector<double> latitude;   // radians; NaN when unknown
+    std::vector<double> longitude;
+    int coordinateCount;
+    double heuristicScale;
+    bool heuristicDirty;
+    uint64_t graphVersion;
+    ContractionHierarchy hierarchy;
+    uint64_t hierarchyVersion;
+    DistanceMatrix matrix;
+    uint64_t matrixVersion;
+    bool matrixValid;
+    // Route weights as of the last all-pairs computation (INT_MAX for routes
+    // that did not exist), for every route changed since.
+    std::unordered_map<uint64_t, int> matrixChanges;
+    DSU connectivity;
+    int componentTotal;
+    bool connectivityStale;  // a route was dropped since the last rebuild
+
+    static uint64_t routeKey(int u, int v);
+    void setRouteWeight(const Route& r, int weight);
+    void removeArc(int u, int pos);
+    void noteRouteChange(int u, int v, int oldWeight);
+    void computeRow(const CsrGraph& g, int s);
+    void refreshConnectivity();
 
-    void dfsUtil(int u, std::vector<bool>& visited);
+    double greatCircle(int a, int b) const;
+    double scaleForHeuristic();
+    int searchOneSided(const CsrGraph& g, int s, int t, bool stopAtTarget, bool goalDirected,
+                       DijkstraContext& ctx, int& settled) const;
+    int searchBidirectional(const CsrGraph& g, int s, int t, DijkstraContext& ctx,
+                            std::vector<int>& path, int& settled) const;
+};
+
+// One timetabled flight as the connection scan sees it. Times are seconds
+// after the timetable's epoch (its earliest departure), so a connection is
+// 20 bytes and a scan reads the array front to back.
+struct Connection {
+    int32_t departure;
+    int32_t arrival;
+    int32_t from;
+    int32_t to;
+    int32_t flight;  // FlightStore slot
+};
+
+struct Journey {
+    int64_t arrival;           // -1 if the destination cannot be reached
+    std::vector<int> flights;  // FlightStore slots in travel order
+};
+
+// Connection Scan Algorithm over the active timetabled flights, kept in one
+// array sorted by departure. An earliest-arrival query binary-searches the
+// first departure after the start time and scans forward once, relaxing each
+// connection whose departure airport is reached in time, until departures pass
+// the best arrival found at the destination. Changing flights at an airport
+// takes at least its minimum connection time; the first flight only has to
+// leave after the start time.
+class ConnectionScan {
+public:
+    ConnectionScan();
+
+    void build(const FlightStore& flights);
+    size_t connectionCount() const { return connections.size(); }
+    size_t memoryBytes() const;
+
+    // Connection times persist across rebuilds.
+    void setDefaultConnectionTime(int seconds);
+    void setMinimumConnectionTime(AirportCode airport, int seconds);
+
+    Journey earliestArrival(AirportCode from, AirportCode to, int64_t departAfter) const;
+
+private:
+    int connectionTime(AirportCode airport) const;
+
+    std::vector<Connection> connections;
+    std::unordered_map<AirportCode, int> airportIndex;
+    std::vector<int> minConnection;  // by airport index
+    std::unordered_map<AirportCode, int> connectionTimes;
+    int defaultConnectionTime;
+    int64_t epoch;
+};
+
+// How far a logged mutation has got by the time the call making it returns.
+enum LogDurability {
+    LOG_BUFFERED,  // in memory; written once 1 MiB has piled up, on flushLog or by a later commit
+    LOG_WRITTEN,   // written to the file: survives the process crashing, not the machine
+    LOG_SYNCED     // on disk; one fdatasync covers every record appended before it
+};
+
+enum LogRecordType {
+    LOG_ADD_FLIGHT = 1,
+    LOG_CANCEL_FLIGHT,
+    LOG_SCHEDULE_FLIGHT,
+    LOG_BOOK,
+    LOG_CANCEL_BOOKING
+};
+
+// A mutation read back from the log. Only the fields of its type are set:
+// the flight for LOG_ADD_FLIGHT, bookingId for the booking records and
+// passengerName for LOG_BOOK.
+struct LogRecord {
+    LogRecordType type;
+    uint64_t sequence;
+    FlightCode flightID;
+    int bookingId = 0;
+    AirportCode source;
+    AirportCode destination;
+    int distance = 0;
+    int seats = 0;
+    int64_t departureTime = 0;
+    int64_t arrivalTime = 0;
+    std::string passengerName;
+};
+
+// Where the log ends: the last sequence number handed out and the file
+// offset its record ends at once written.
+struct LogPosition {
+    uint64_t sequence;
+    uint64_t offset;
+};
+
+struct LogStats {
+    uint64_t records;
+    uint64_t bytes;
+    uint64_t writes;  // write batches handed to the file
+    uint64_t syncs;   // fdatasync calls, each covering every record written before it
+};
+
+// Append-only log of checksummed, sequence-numbered mutation records. Appends
+// only copy the record into a buffer under the lock; commit() then makes
+// everything up to a sequence number as durable as the log is configured
+// for. Commits arriving together are served by a single write and, for
+// LOG_SYNCED, a single fdatasync (group commit): one committer does the I/O
+// without the lock while the rest wait for it, and groupCommitMicros makes
+// it wait that long first so more records join the batch. Once a write or
+// sync fails the log stops taking records and failed() stays true.
+class WriteAheadLog {
+public:
+    static const size_t BUFFER_LIMIT = 1 << 20;
+
+    WriteAheadLog();
+    ~WriteAheadLog();
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    // Reads path, hands replay every record after lastSequence() in order,
+    // cuts off a torn record at the end and opens the file for appending.
+    // Returns the number of records replayed, or -1 if the file cannot be
+    // opened, a record is missing after lastSequence() or replay returned
+    // false (lastSequence() is then the last record applied).
+    long long open(const std::string& path, LogDurability durability, int groupCommitMicros,
+                   const std::function<bool(const LogRecord&)>& replay);
+    // Writes and syncs what is buffered, then closes the file.
+    bool close();
+    bool isOpen() const;
+
+    // Each returns the record's sequence number, or 0 if the log is closed.
+    uint64_t appendFlight(const Flight& f);
+    uint64_t appendFlightState(FlightCode flightID, bool active);
+    uint64_t appendBooking(FlightCode flightID, int bookingId, const std::string& passengerName);
+    uint64_t appendCancellation(FlightCode flightID, int bookingId);
+
+    bool commit(uint64_t sequence);
+    // Writes and syncs everything appended so far, whatever the durability.
+    bool flush();
+    // Rewrites the file without the records up to position, which must come
+    // from position() on the file that is open now.
+    bool discardThrough(LogPosition position);
+
+    uint64_t lastSequence() const;
+    // Sets the sequence number the next record follows; the log must be closed.
+    void setSequence(uint64_t sequence);
+    LogPosition position() const;
+    LogStats stats() const;
+    bool failed() const;
+
+private:
+    uint64_t append(LogRecordType type, FlightCode flightID, int bookingId, const void* tail, uint32_t tailSize);
+    bool flushLocked(std::unique_lock<std::mutex>& guard, uint64_t sequence, bool sync);
+    bool writeBufferLocked();
+
+    std::string path;
+    int fd;
+    LogDurability durability;
+    std::chrono::microseconds groupCommitWindow;
+    mutable std::mutex lock;
+    std::condition_variable flushDone;
+    std::vector<char> buffer;   // records not yet written
+    std::vector<char> writing;  // the batch being written by the flushing committer
+    uint64_t appended;          // last sequence number handed out
+    uint64_t written;
+    uint64_t synced;
+    uint64_t fileSize;          // bytes in the file
+    uint64_t endOffset;         // where the file will end once everything appended is written
+    bool flushing;
+    bool broken;
+    LogStats counters;
+};
+
+// Failure codes returned in place of a booking ID by FlightSystem::bookBatch.
+enum BookingStatus {
+    BOOKING_FLIGHT_NOT_FOUND = -1,
+    BOOKING_FLIGHT_INACTIVE = -2,
+    BOOKING_SOLD_OUT = -3
+};
+
+struct BookingRequest {
+    int flightIndex;
+    std::string passengerName;
+};
+
+// A line loadFlightsCsv rejected, numbered from 1.
+struct LoadError {
+    long line;
+    std::string reason;
+};
+
+struct LoadReport {
+    bool opened;    // false if the file could not be mapped
+    int loaded;     // flights added
+    long rejected;  // lines rejected
+    std::vector<LoadError> errors;  // the first MAX_LOAD_ERRORS rejected lines, in line order
 };
 
 class FlightSystem {
 public:
+    static const int BOOKING_QUEUE_CAPACITY = 1 << 16;
+    static const int MAX_LOAD_ERRORS = 1000;
+
     FlightSystem();
+    ~FlightSystem();
 
     void addFlight();
     void cancelFlight();
@@ -101,34 +1016,215 @@ public:
     void runPrimMST();
     void runKruskalMST();
 
+    // Returns false if the ID is taken, a code does not fit or distance or
+    // seats is negative.
     bool addFlightParams(const std::string& flightID,
                          const std::string& source,
                          const std::string& destination,
                          int distance,
-                         int seats);
+                         int seats,
+                         int64_t departureTime = 0,
+                         int64_t arrivalTime = 0);
 
     std::vector<Flight> listFlights() const;
 
+    // Safe to call from many threads at once, and alongside flights being added.
+    // Returns false if the flight is unknown or inactive, or if the booking
+    // queue is full; the flight is checked again when the booking is confirmed.
     bool queueBooking(const std::string& flightID, const std::string& passengerName);
 
+    // Starts a consumer thread that confirms queued bookings as they arrive.
+    // While it runs, processNextBooking* report the worker instead of popping.
+    // stopBookingWorker drains what is already queued, then joins.
+    void startBookingWorker();
+    void stopBookingWorker();
+    bool bookingWorkerRunning() const { return workerRunning.load(); }
+
     std::pair<bool, std::string> processNextBookingNonInteractive(const std::string& passengerName);
 
+    // Confirms many (flightID, passengerName) requests in one call. Requests
+    // are grouped by flight and each flight's seats are reserved in one pass,
+    // in request order. Returns, per request, the booking ID or a negative
+    // BookingStatus.
+    std::vector<int> bookBatch(const std::vector<std::pair<std::string, std::string>>& requests);
+
     bool cancelBookingById(const std::string& flightID, int bookingId);
 
+    // Lock-free seat availability; -1 if the flight is unknown.
+    int availableSeats(const std::string& flightID) const;
+    // Holds take seats for ttlMillis; confirmHoldBooking turns a hold into
+    // one booking per passenger name. If names.size() differs from the hold
+    // size it books nobody and the hold stays as it was.
+    uint64_t holdSeats(const std::string& flightID, int count, int ttlMillis);
+    std::vector<int> confirmHoldBooking(uint64_t holdId, const std::vector<std::string>& passengerNames);
+    bool releaseHold(uint64_t holdId);
+    int expireHolds();
+
     std::vector<std::pair<int, std::string>> getBookingsForFlight(const std::string& flightID) const;
 
+    // Active flights matching the query as FlightStore slots (see flightAt),
+    // in the order they were added. Spans point into the search index and are
+    // read without locking, so do not hold one across addFlight, cancelFlight
+    // or scheduleFlight.
+    SlotSpan flightsFromSource(const std::string& source) const;
+    SlotSpan flightsToDestination(const std::string& destination) const;
+    SlotSpan searchFlightsByRoute(const std::string& source, const std::string& destination) const;
+    const Flight& flightAt(int slot) const { return flights[slot]; }
+    // The same queries copied out under bookingMutex, for callers that may
+    // run alongside those mutators (the Python module uses these).
+    std::vector<Flight> flightsToDestinationList(const std::string& destination) const;
+    std::vector<Flight> searchFlightsByRouteList(const std::string& source, const std::string& destination) const;
+
     std::vector<Flight> searchFlightsBySourceNonInteractive(const std::string& source);
 
+    // Recently searched sources, most recent first; each appears once.
     std::vector<std::string> recentSearchesList() const;
+    // The k most searched sources among those still in the history.
+    std::vector<std::pair<std::string, int>> topSearches(int k) const;
+
+    // Shortest route between two airports as (distance, airport names), or
+    // (INT_MAX, []) if there is none; see RouteMode for the strategies.
+    std::pair<int, std::vector<std::string>> dijkstraPath(const std::string& src, const std::string& dest,
+                                                          RouteMode mode = ROUTE_AUTO);
+    // Airport names in depth-first / breadth-first order from start, at most
+    // maxDepth routes away (-1: no limit); empty if start is unknown.
+    std::vector<std::string> dfsOrder(const std::string& start, int maxDepth = -1);
+    std::vector<std::string> bfsOrder(const std::string& start, int maxDepth = -1);
+    // Every airport reachable from start with its number of routes from it.
+    std::vector<std::pair<std::string, int>> reachableAirports(const std::string& start, int maxDepth = -1);
+    // Minimum spanning forest of the route network as (from, to, distance),
+    // by ascending distance, computed on `threads` workers (0 = all cores).
+    std::vector<std::tuple<std::string, std::string, int>> minimumSpanningForest(int threads = 0);
+    // Whether some chain of active flights links two airports, the number of
+    // airports in an airport's component, and every component's airports.
+    bool airportsConnected(const std::string& a, const std::string& b);
+    int componentSize(const std::string& airport);
+    std::vector<std::vector<std::string>> connectedComponents();
+
+    // Up to k alternative routes as (distance, airport names), shortest
+    // first, each at most maxLegs flights long (0 = no limit) and avoiding
+    // the excluded airports.
+    std::vector<std::pair<int, std::vector<std::string>>> alternativeRoutes(const std::string& src,
+                                                                            const std::string& dest, int k,
+                                                                            int maxLegs = 0,
+                                                                            const std::vector<std::string>& excluded = {});
+    bool setAirportCoordinates(const std::string& airport, double latitude, double longitude);
+
+    // Earliest arrival at dest leaving src no earlier than departAfter (Unix
+    // seconds), as (arrival time, flight IDs), or (-1, []) if no connection
+    // exists. The timetable is rebuilt on the first query after flights were
+    // added, cancelled or scheduled.
+    std::pair<int64_t, std::vector<std::string>> earliestArrival(const std::string& src, const std::string& dest,
+                                                                 int64_t departAfter);
+    void setDefaultConnectionTime(int seconds);
+    bool setMinimumConnectionTime(const std::string& airport, int seconds);
 
-    std::pair<int, std::vector<std::string>> dijkstraPath(const std::string& src, const std::string& dest);
+    // Schedule publication hook: rebuilds the route index if the network
+    // changed since the last publication. Returns true if it rebuilt.
+    // dijkstraPath(..., ROUTE_CONTRACTED) falls back to a plain search
+    // while the index is out of date.
+    bool publishSchedule();
+
+    // All-pairs distance matrix over the route network. refreshDistanceMatrix
+    // recomputes only the rows affected by changes since the last call and
+    // returns how many. distanceMatrix() shares the storage rather than
+    // copying it: rows are overwritten in place by later refreshes, and row i
+    // belongs to matrixAirports()[i].
+    void computeDistanceMatrix(int threads = 0);
+    int refreshDistanceMatrix(int threads = 0);
+    DistanceMatrix distanceMatrix() const;
+    std::vector<std::string> matrixAirports() const;
+
+    // Versioned binary snapshot of flights, bookings and the route graph
+    // (airport index and CSR). saveSnapshot writes a temporary file beside
+    // path, syncs it and renames it over path, so a crash leaves either the
+    // old or the new snapshot. loadSnapshot maps the file and rebuilds every
+    // structure straight from its arrays, replacing the flights, bookings and
+    // graph; queued bookings, seat holds and cached searches are dropped. It
+    // returns false, leaving the state alone, if the file cannot be read, is
+    // of another version or is inconsistent.
+    bool saveSnapshot(const std::string& path);
+    bool loadSnapshot(const std::string& path);
+
+    // Write-ahead log of flights added, cancelled and scheduled and of
+    // bookings made and cancelled. openLog replays path on top of the current
+    // state, normally just loaded with loadSnapshot, skipping the records the
+    // snapshot already holds, and from then on every such call logs its
+    // mutation and returns once it is as durable as `durability` asks; see
+    // WriteAheadLog for groupCommitMicros. It returns the number of records
+    // replayed, or -1 if the log cannot be opened, does not follow on from
+    // the snapshot or holds a record that does not apply, in which case the
+    // records before it stay applied and the log stays closed. loadSnapshot
+    // fails while a log is open.
+    long long openLog(const std::string& path, LogDurability durability = LOG_SYNCED, int groupCommitMicros = 0);
+    bool closeLog();
+    bool flushLog();
+    // saveSnapshot, then drop from the log every record the snapshot holds.
+    // Not to be run alongside openLog or closeLog.
+    bool checkpoint(const std::string& snapshotPath);
+    LogStats logStats() const;
+    // False once a log write or sync has failed; mutations still apply in
+    // memory but are no longer logged.
+    bool logHealthy() const;
+
+    // Mark a flight cancelled / active again; false if it is unknown.
+    bool cancelFlightById(const std::string& flightID);
+    bool scheduleFlightById(const std::string& flightID);
+
+    // Bulk load of a flights file in the flights_db.txt format, one
+    // `flightID,source,destination,distance,seats,active` row per line with
+    // active True or False in any case; fields are trimmed and blank lines
+    // skipped. The file is mapped and parsed in chunks on `threads` workers
+    // (0 = one per core) without copying fields into strings. Rows that parse
+    // and whose flight ID is new are added as addFlightParams adds them, then
+    // cancelled if inactive, but the ID table, B+ tree, search index and route
+    // graph are each rebuilt once for the whole file. A line is rejected if it
+    // does not parse, has a negative distance or seat count, or repeats an ID
+    // already loaded or seen on an earlier line. Added flights are logged,
+    // with one commit for the file. The graph's cached route index and
+    // distance matrix are dropped.
+    LoadReport loadFlightsCsv(const std::string& path, int threads = 0);
 
 private:
-    Flight flights[MAX_FLIGHTS];
-    int flightCount;
-    FlightBST bst;
-    std::stack<std::string> recentSearches;
-    std::queue<int> bookingQueue;
+    Flight* findFlight(const std::string& flightID);
+    int findFlightIndex(const std::string& flightID) const;
+    bool insertFlight(FlightCode id, AirportCode source, AirportCode destination, int distance, int seats,
+                      int64_t departureTime, int64_t arrivalTime);
+    bool setFlightActive(int flightIndex, bool active);
+    int addBooking(int flightIndex, const std::string& passengerName);
+    int confirmBooking(int flightIndex, const std::string& passengerName);
+    bool applyLogRecord(const LogRecord& record);
+    bool writeSnapshot(const std::string& path, LogPosition& position);
+    void bookingWorkerLoop();
+    void invalidateSearch(AirportCode source);
+
+    FlightStore flights;
+    FlightIdMap flightIds;
+    // Lookups in flightIds take it shared; changes to flightIds take it
+    // exclusive, after bookingMutex.
+    mutable std::shared_mutex flightIdMutex;
+    FlightIndex flightIndex;
+    FlightSearchIndex searchIndex;
+    SearchHistory recentSearches;
+    mutable std::mutex searchMutex;
+    MpscQueue<BookingRequest> bookingQueue;
+    // Held by whoever pops bookingQueue, which allows one consumer at a
+    // time; taken before bookingMutex.
+    std::mutex queueConsumerMutex;
+    BookingTable bookings;
+    SeatInventory seatInventory;
+    mutable std::mutex bookingMutex;
+    std::thread bookingWorker;
+    std::atomic<bool> workerRunning;
+    std::atomic<bool> workerStop;
     AirportGraph graph;
-    int globalBookingId;
+    // Taken after bookingMutex when both are needed; dijkstraPath only takes
+    // it shared once the graph is prepared for queries.
+    mutable std::shared_mutex graphMutex;
+    ConnectionScan timetable;
+    std::atomic<bool> timetableDirty;
+    mutable std::shared_mutex timetableMutex;  // taken after bookingMutex
+    // Records are appended under bookingMutex where it is held, so their
+    // order is the order the mutations happened in.
+    WriteAheadLog wal;
 };
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <iostream>
 #include <algorithm>
 #include <climits>
+#include <cmath>
 
 using namespace std;
 
@@ -9,7 +10,24 @@ BookingNode::BookingNode(int id, const std::string& name)
     : bookingId(id), passengerName(name), next(nullptr) {}
 
 Flight::Flight()
-    : flightID(), source(), destination(), distance(0), seats(0), active(true), bookingHead(nullptr) {}
+    : flightID(), source(), destination(), distance(0), seats(0), active(true), departureTime(0), arrivalTime(0) {}
+
+Flight::Flight(const Flight& other)
+    : flightID(other.flightID), source(other.source), destination(other.destination),
+      distance(other.distance), seats(other.seats.load()), active(other.active.load()),
+      departureTime(other.departureTime), arrivalTime(other.arrivalTime) {}
+
+Flight& Flight::operator=(const Flight& other) {
+    flightID = other.flightID;
+    source = other.source;
+    destination = other.destination;
+    distance = other.distance;
+    seats.store(other.seats.load());
+    active.store(other.active.load());
+    departureTime = other.departureTime;
+    arrivalTime = other.arrivalTime;
+    return *this;
+}
 
 FlightBSTNode::FlightBSTNode(Flight* f)
     : flightPtr(f), left(nullptr), right(nullptr) {}
@@ -45,12 +63,12 @@ void FlightBST::inorderRec(FlightBSTNode* node) {
     if (f->active) {
         cout << f->flightID << ": " << f->source << " -> "
              << f->destination << ", Dist: " << f->distance
-             << ", Seats: " << f->seats << '\n';
+             << ", Seats: " << f->seats.load() << '\n';
     }
     inorderRec(node->right);
 }
 
-Flight* FlightBST::searchRec(FlightBSTNode* node, const std::string& id) {
+Flight* FlightBST::searchRec(FlightBSTNode* node, FlightCode id) {
     if (!node) return nullptr;
     if (id == node->flightPtr->flightID) return node->flightPtr;
     if (id < node->flightPtr->flightID) return searchRec(node->left, id);
@@ -61,7 +79,7 @@ void FlightBST::insert(Flight* f) {
     root = insertRec(root, f);
 }
 
-Flight* FlightBST::search(const std::string& id) {
+Flight* FlightBST::search(FlightCode id) {
     return searchRec(root, id);
 }
 
@@ -69,107 +87,186 @@ void FlightBST::displayInOrder() {
     inorderRec(root);
 }
 
-AirportGraph::AirportGraph() {}
+AirportGraph::AirportGraph() : airportIndex(), indexToAirport(), adj(), routes(), csr(), csrDirty(true),
+      latitude(), longitude(), coordinateCount(0), heuristicScale(0), heuristicDirty(true),
+      graphVersion(0), hierarchy(), hierarchyVersion(0), matrix(), matrixVersion(0), matrixValid(false),
+      matrixChanges(), connectivity(), componentTotal(0), connectivityStale(false) {}
 
-int AirportGraph::getAirportIndex(const std::string& name) {
+int AirportGraph::getAirportIndex(AirportCode name) {
     auto it = airportIndex.find(name);
     if (it != airportIndex.end()) return it->second;
     int idx = static_cast<int>(indexToAirport.size());
     airportIndex[name] = idx;
     indexToAirport.push_back(name);
     adj.push_back({});
+    latitude.push_back(NAN);
+    longitude.push_back(NAN);
+    connectivity.add();
+    componentTotal++;
+    csrDirty = true;
+    graphVersion++;
     return idx;
 }
 
-void AirportGraph::addEdge(const std::string& src, const std::string& dest, int dist) {
+uint64_t AirportGraph::routeKey(int u, int v) {
+    if (u > v) swap(u, v);
+    return (static_cast<uint64_t>(u) << 32) | static_cast<uint32_t>(v);
+}
+
+void AirportGraph::setRouteWeight(const Route& r, int weight) {
+    noteRouteChange(r.u, r.v, adj[r.u][r.posU].weight);
+    adj[r.u][r.posU].weight = weight;
+    adj[r.v][r.posV].weight = weight;
+    heuristicDirty = true;
+    graphVersion++;
+    if (!csrDirty) {
+        csr.weights[csr.offsets[r.u] + r.posU] = weight;
+        csr.weights[csr.offsets[r.v] + r.posV] = weight;
+    }
+}
+
+// Swap-removes adj[u][pos] and repoints the route of the arc moved into its place.
+void AirportGraph::removeArc(int u, int pos) {
+    vector<Arc>& arcs = adj[u];
+    arcs[pos] = arcs.back();
+    arcs.pop_back();
+    if (pos == static_cast<int>(arcs.size())) return;
+    Route& moved = routes.find(routeKey(u, arcs[pos].to))->second;
+    if (moved.u == u) moved.posU = pos;
+    else moved.posV = pos;
+}
+
+void AirportGraph::addEdge(AirportCode src, AirportCode dest, int dist) {
     int u = getAirportIndex(src);
     int v = getAirportIndex(dest);
-    adj[u].push_back({v, dist});
-    adj[v].push_back({u, dist});
+    if (u == v) return;
+    auto it = routes.find(routeKey(u, v));
+    if (it == routes.end()) {
+        Route r{u, v, static_cast<int>(adj[u].size()), static_cast<int>(adj[v].size()), {dist}};
+        adj[u].push_back({v, dist});
+        adj[v].push_back({u, dist});
+        routes.emplace(routeKey(u, v), std::move(r));
+        noteRouteChange(u, v, INT_MAX);
+        if (connectivity.unite(u, v)) componentTotal--;
+        csrDirty = true;
+        heuristicDirty = true;
+        graphVersion++;
+        return;
+    }
+    Route& r = it->second;
+    r.distances.push_back(dist);
+    if (dist < adj[r.u][r.posU].weight) setRouteWeight(r, dist);
+}
+
+// Withdraws one flight's distance from its route; the route disappears with
+// its last flight. Returns false if no active flight had that distance.
+bool AirportGraph::removeEdge(AirportCode src, AirportCode dest, int dist) {
+    auto a = airportIndex.find(src), b = airportIndex.find(dest);
+    if (a == airportIndex.end() || b == airportIndex.end()) return false;
+    if (a->second == b->second) return true;
+    auto it = routes.find(routeKey(a->second, b->second));
+    if (it == routes.end()) return false;
+    Route& r = it->second;
+    auto d = find(r.distances.begin(), r.distances.end(), dist);
+    if (d == r.distances.end()) return false;
+    *d = r.distances.back();
+    r.distances.pop_back();
+    if (!r.distances.empty()) {
+        int weight = *min_element(r.distances.begin(), r.distances.end());
+        if (weight != adj[r.u][r.posU].weight) setRouteWeight(r, weight);
+        return true;
+    }
+    int u = r.u, v = r.v, posU = r.posU, posV = r.posV;
+    noteRouteChange(u, v, adj[u][posU].weight);
+    routes.erase(it);
+    removeArc(u, posU);
+    removeArc(v, posV);
+    connectivityStale = true;
+    csrDirty = true;
+    graphVersion++;
+    return true;
 }
 
-void AirportGraph::dfsUtil(int u, std::vector<bool>& visited) {
-    visited[u] = true;
-    cout << indexToAirport[u] << " ";
-    for (auto &p : adj[u]) {
-        int v = p.first;
-        if (!visited[v]) dfsUtil(v, visited);
+const CsrGraph& AirportGraph::snapshot() {
+    if (!csrDirty) return csr;
+    int n = static_cast<int>(adj.size());
+    csr.offsets.assign(n + 1, 0);
+    for (int u = 0; u < n; ++u) csr.offsets[u + 1] = csr.offsets[u] + static_cast<int>(adj[u].size());
+    csr.targets.resize(csr.offsets[n]);
+    csr.weights.resize(csr.offsets[n]);
+    for (int u = 0; u < n; ++u) {
+        int k = csr.offsets[u];
+        for (const Arc& a : adj[u]) {
+            csr.targets[k] = a.to;
+            csr.weights[k] = a.weight;
+            k++;
+        }
     }
+    csrDirty = false;
+    return csr;
 }
 
-void AirportGraph::DFS(const std::string& start) {
+void AirportGraph::DFS(AirportCode start) {
     if (!airportIndex.count(start)) {
         cout << "Airport not found.\n";
         return;
     }
-    vector<bool> visited(adj.size(), false);
+    vector<int> order;
+    depthFirst(start, order);
     cout << "DFS from " << start << ": ";
-    dfsUtil(airportIndex[start], visited);
+    for (int u : order) cout << indexToAirport[u] << " ";
     cout << '\n';
 }
 
-void AirportGraph::BFS(const std::string& start) {
+void AirportGraph::BFS(AirportCode start) {
     if (!airportIndex.count(start)) {
         cout << "Airport not found.\n";
         return;
     }
-    vector<bool> visited(adj.size(), false);
-    queue<int> q;
-    int s = airportIndex[start];
-    visited[s] = true;
-    q.push(s);
+    vector<int> order;
+    breadthFirst(start, order);
     cout << "BFS from " << start << ": ";
-    while (!q.empty()) {
-        int u = q.front(); q.pop();
-        cout << indexToAirport[u] << " ";
-        for (auto &p : adj[u]) {
-            int v = p.first;
-            if (!visited[v]) {
-                visited[v] = true;
-                q.push(v);
-            }
-        }
-    }
+    for (int u : order) cout << indexToAirport[u] << " ";
     cout << '\n';
 }
 
-void AirportGraph::dijkstra(const std::string& source, const std::string& dest) {
+void AirportGraph::dijkstra(AirportCode source, AirportCode dest) {
     if (!airportIndex.count(source) || !airportIndex.count(dest)) {
         cout << "Source or destination airport not found.\n";
         return;
     }
-    int n = static_cast<int>(adj.size());
-    vector<int> dist(n, INT_MAX);
-    vector<int> parent(n, -1);
-    using PII = pair<int,int>;
-    priority_queue<PII, vector<PII>, greater<PII>> pq;
+    const CsrGraph& g = snapshot();
+    DijkstraContext& ctx = DijkstraContext::local();
+    SearchLabels& labels = ctx.labels[0];
+    RadixHeap& pq = ctx.heap[0];
+    labels.reset(g.nodeCount());
+    pq.clear();
 
     int s = airportIndex[source];
     int t = airportIndex[dest];
-    dist[s] = 0;
-    pq.push({0, s});
+    labels.set(s, 0, -1);
+    pq.push(0, s);
 
     while (!pq.empty()) {
         auto [d, u] = pq.top(); pq.pop();
-        if (d != dist[u]) continue;
-        for (auto &p : adj[u]) {
-            int v = p.first, w = p.second;
-            if (dist[u] != INT_MAX && dist[u] + w < dist[v]) {
-                dist[v] = dist[u] + w;
-                parent[v] = u;
-                pq.push({dist[v], v});
+        if (d != labels.dist(u)) continue;
+        for (int e = g.begin(u); e < g.end(u); ++e) {
+            int v = g.targets[e], w = g.weights[e];
+            if (d + w < labels.dist(v)) {
+                labels.set(v, d + w, u);
+                pq.push(d + w, v);
             }
         }
     }
 
-    if (dist[t] == INT_MAX) {
+    if (labels.dist(t) == INT_MAX) {
         cout << "No path found between " << source << " and " << dest << ".\n";
         return;
     }
 
-    cout << "Shortest distance from " << source << " to " << dest << " = " << dist[t] << "\n";
+    cout << "Shortest distance from " << source << " to " << dest << " = " << labels.dist(t) << "\n";
     vector<int> path;
-    for (int cur = t; cur != -1; cur = parent[cur]) path.push_back(cur);
+    for (int cur = t; cur != -1; cur = labels.parent(cur)) path.push_back(cur);
     reverse(path.begin(), path.end());
     cout << "Path: ";
     for (size_t i = 0; i < path.size(); ++i) {
@@ -179,86 +276,21 @@ void AirportGraph::dijkstra(const std::string& source, const std::string& dest)
     cout << "\n";
 }
 
-std::pair<int, std::vector<std::string>> AirportGraph::dijkstra_path(const std::string& source, const std::string& dest) {
-    if (!airportIndex.count(source) || !airportIndex.count(dest)) {
-        return {INT_MAX, {}};
-    }
-    int n = static_cast<int>(adj.size());
-    vector<int> dist(n, INT_MAX);
-    vector<int> parent(n, -1);
-    using PII = pair<int,int>;
-    priority_queue<PII, vector<PII>, greater<PII>> pq;
-
-    int s = airportIndex[source];
-    int t = airportIndex[dest];
-    dist[s] = 0;
-    pq.push({0, s});
-
-    while (!pq.empty()) {
-        auto [d, u] = pq.top(); pq.pop();
-        if (d != dist[u]) continue;
-        for (auto &p : adj[u]) {
-            int v = p.first, w = p.second;
-            if (dist[u] != INT_MAX && dist[u] + w < dist[v]) {
-                dist[v] = dist[u] + w;
-                parent[v] = u;
-                pq.push({dist[v], v});
-            }
-        }
-    }
-
-    if (dist[t] == INT_MAX) {
-        return {INT_MAX, {}};
-    }
-
-    vector<int> pathIdx;
-    for (int cur = t; cur != -1; cur = parent[cur]) pathIdx.push_back(cur);
-    reverse(pathIdx.begin(), pathIdx.end());
-    vector<string> pathNames;
-    for (int idx : pathIdx) pathNames.push_back(indexToAirport[idx]);
-    return {dist[t], pathNames};
+std::pair<int, std::vector<AirportCode>> AirportGraph::dijkstra_path(AirportCode source, AirportCode dest) {
+    return shortestPath(source, dest, ROUTE_FULL);
 }
 
-void AirportGraph::primMST(const std::string& start) {
+void AirportGraph::primMST(AirportCode start) {
     if (!airportIndex.count(start)) {
         cout << "Airport not found.\n";
         return;
     }
-    int n = static_cast<int>(adj.size());
-    vector<int> key(n, INT_MAX);
-    vector<int> parent(n, -1);
-    vector<bool> inMST(n, false);
-    using PII = pair<int,int>;
-    priority_queue<PII, vector<PII>, greater<PII>> pq;
-
-    int s = airportIndex[start];
-    key[s] = 0;
-    pq.push({0, s});
-
-    while (!pq.empty()) {
-        int u = pq.top().second; pq.pop();
-        if (inMST[u]) continue;
-        inMST[u] = true;
-        for (auto &p : adj[u]) {
-            int v = p.first, w = p.second;
-            if (!inMST[v] && w < key[v]) {
-                key[v] = w;
-                parent[v] = u;
-                pq.push({key[v], v});
-            }
-        }
-    }
-
+    SpanningForest tree = primTree(start);
     cout << "Prim's MST edges:\n";
-    int total = 0;
-    for (int v = 0; v < n; ++v) {
-        if (parent[v] != -1) {
-            cout << indexToAirport[parent[v]] << " - " << indexToAirport[v]
-                 << " (" << key[v] << ")\n";
-            total += key[v];
-        }
+    for (const SpanningEdge& e : tree.edges) {
+        cout << e.from << " - " << e.to << " (" << e.distance << ")\n";
     }
-    cout << "Total MST weight = " << total << "\n";
+    cout << "Total MST weight = " << tree.weight << "\n";
 }
 
 AirportGraph::DSU::DSU(int n) {
@@ -267,87 +299,166 @@ AirportGraph::DSU::DSU(int n) {
 
 void AirportGraph::DSU::init(int n) {
     parent.resize(n);
-    rnk.assign(n, 0);
+    size.assign(n, 1);
     for (int i = 0; i < n; ++i) parent[i] = i;
 }
 
+int AirportGraph::DSU::add() {
+    parent.push_back(static_cast<int>(parent.size()));
+    size.push_back(1);
+    return parent.back();
+}
+
+// Iterative, so long parent chains cannot exhaust the stack: one pass to the
+// root, a second to point the whole chain at it.
 int AirportGraph::DSU::find(int x) {
-    if (parent[x] == x) return x;
-    return parent[x] = find(parent[x]);
+    int root = x;
+    while (parent[root] != root) root = parent[root];
+    while (parent[x] != root) {
+        int next = parent[x];
+        parent[x] = root;
+        x = next;
+    }
+    return root;
 }
 
 bool AirportGraph::DSU::unite(int a, int b) {
     a = find(a); b = find(b);
     if (a == b) return false;
-    if (rnk[a] < rnk[b]) swap(a, b);
+    if (size[a] < size[b]) swap(a, b);
     parent[b] = a;
-    if (rnk[a] == rnk[b]) rnk[a]++;
+    size[a] += size[b];
     return true;
 }
 
 void AirportGraph::kruskalMST() {
-    int n = static_cast<int>(adj.size());
-    vector<Edge> edges;
-    for (int u = 0; u < n; ++u) {
-        for (auto &p : adj[u]) {
-            int v = p.first, w = p.second;
-            if (u < v) edges.push_back({u, v, w});
-        }
-    }
-    sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
-        return a.w < b.w;
-    });
-
-    DSU dsu(n);
-    int total = 0;
+    SpanningForest forest = kruskalForest();
     cout << "Kruskal's MST edges:\n";
-    for (auto &e : edges) {
-        if (dsu.unite(e.u, e.v)) {
-            cout << indexToAirport[e.u] << " - " << indexToAirport[e.v]
-                 << " (" << e.w << ")\n";
-            total += e.w;
-        }
+    for (const SpanningEdge& e : forest.edges) {
+        cout << e.from << " - " << e.to << " (" << e.distance << ")\n";
     }
-    cout << "Total MST weight = " << total << "\n";
+    cout << "Total MST weight = " << forest.weight << "\n";
+}
+
+// Airport names typed at the CLI that do not fit an AirportCode map to the
+// empty code, which no airport uses, so lookups simply report "not found".
+static AirportCode toAirport(const std::string& name) {
+    AirportCode code;
+    AirportCode::parse(name, code);
+    return code;
 }
 
 FlightSystem::FlightSystem()
-    : flightCount(0), bst(), recentSearches(), bookingQueue(), graph(), globalBookingId(1) {}
+    : flights(), flightIds(flights), flightIdMutex(), flightIndex(), searchIndex(), recentSearches(), searchMutex(), bookingQueue(BOOKING_QUEUE_CAPACITY),
+      queueConsumerMutex(), bookings(),
+      seatInventory(flights), bookingMutex(), bookingWorker(), workerRunning(false), workerStop(false), graph(), graphMutex(),
+      timetable(), timetableDirty(false), timetableMutex(), wal() {}
+
+FlightSystem::~FlightSystem() {
+    stopBookingWorker();
+}
 
 void FlightSystem::addFlight() {
-    if (flightCount >= MAX_FLIGHTS) {
-        cout << "Cannot add more flights.\n";
-        return;
-    }
-    Flight &f = flights[flightCount];
+    string id, src, dst;
+    int distance, seats;
     cout << "Enter Flight ID: ";
-    cin >> f.flightID;
+    cin >> id;
     cout << "Enter Source: ";
-    cin >> f.source;
+    cin >> src;
     cout << "Enter Destination: ";
-    cin >> f.destination;
+    cin >> dst;
     cout << "Enter Distance: ";
-    cin >> f.distance;
+    cin >> distance;
     cout << "Enter Seats: ";
-    cin >> f.seats;
-    f.active = true;
-    f.bookingHead = nullptr;
-    bst.insert(&f);
+    cin >> seats;
+    int index = flights.size();
+    if (!addFlightParams(id, src, dst, distance, seats)) {
+        cout << "Flight " << id << " not added: ID already exists, a code is too long or a number is negative.\n";
+        return;
+    }
+    cout << "Flight added at index " << index << ".\n";
+}
+
+bool FlightSystem::addFlightParams(const std::string& flightID,
+                                   const std::string& source,
+                                   const std::string& destination,
+                                   int distance,
+                                   int seats,
+                                   int64_t departureTime,
+                                   int64_t arrivalTime) {
+    FlightCode id;
+    AirportCode src, dst;
+    if (!FlightCode::parse(flightID, id) || !AirportCode::parse(source, src) || !AirportCode::parse(destination, dst)) {
+        return false;
+    }
+    uint64_t logged;
+    {
+        lock_guard<mutex> lock(bookingMutex);
+        if (!insertFlight(id, src, dst, distance, seats, departureTime, arrivalTime)) return false;
+        logged = wal.lastSequence();
+    }
+    wal.commit(logged);
+    return true;
+}
+
+// Caller holds bookingMutex, so the flight is logged before anything that
+// finds it by ID can book or cancel it.
+bool FlightSystem::insertFlight(FlightCode id, AirportCode source, AirportCode destination, int distance, int seats,
+                                int64_t departureTime, int64_t arrivalTime) {
+    // Negative distances would break the radix heap's monotone keys, so they
+    // are refused here, which covers log replay as well as addFlightParams.
+    if (id.empty() || distance < 0 || seats < 0 || flightIds.find(id) >= 0) return false;
+    int index = flights.size();
+    Flight &f = flights.append();
+    f.flightID = id;
+    f.source = source;
+    f.destination = destination;
+    f.distance = distance;
+    f.seats.store(seats);
+    f.departureTime = departureTime;
+    f.arrivalTime = arrivalTime;
+    wal.appendFlight(f);
+    {
+        lock_guard<shared_mutex> idLock(flightIdMutex);
+        flightIds.insert(index);
+    }
+    flightIndex.insert(&f);
+    searchIndex.add(f, index);
+    invalidateSearch(f.source);
+    if (f.arrivalTime > f.departureTime) timetableDirty = true;
+    lock_guard<shared_mutex> graphLock(graphMutex);
     graph.addEdge(f.source, f.destination, f.distance);
-    cout << "Flight added at index " << flightCount << ".\n";
-    flightCount++;
+    return true;
+}
+
+int FlightSystem::findFlightIndex(const std::string& flightID) const {
+    FlightCode id;
+    if (!FlightCode::parse(flightID, id)) return -1;
+    shared_lock<shared_mutex> idLock(flightIdMutex);
+    return flightIds.find(id);
+}
+
+Flight* FlightSystem::findFlight(const std::string& flightID) {
+    int index = findFlightIndex(flightID);
+    return index < 0 ? nullptr : &flights[index];
+}
+
+std::vector<Flight> FlightSystem::listFlights() const {
+    vector<Flight> out;
+    lock_guard<mutex> lock(bookingMutex);
+    out.reserve(flights.size());
+    for (int i = 0; i < flights.size(); ++i) out.push_back(flights[i]);
+    return out;
 }
 
 void FlightSystem::cancelFlight() {
     string id;
     cout << "Enter Flight ID to cancel: ";
     cin >> id;
-    Flight* f = bst.search(id);
-    if (!f) {
+    if (!cancelFlightById(id)) {
         cout << "Flight not found.\n";
         return;
     }
-    f->active = false;
     cout << "Flight " << id << " marked as cancelled.\n";
 }
 
@@ -355,69 +466,253 @@ void FlightSystem::scheduleFlight() {
     string id;
     cout << "Enter Flight ID to schedule/activate: ";
     cin >> id;
-    Flight* f = bst.search(id);
-    if (!f) {
+    if (!scheduleFlightById(id)) {
         cout << "Flight not found.\n";
         return;
     }
-    f->active = true;
     cout << "Flight " << id << " marked as active/scheduled.\n";
 }
 
+bool FlightSystem::cancelFlightById(const std::string& flightID) {
+    int index = findFlightIndex(flightID);
+    if (index < 0) return false;
+    uint64_t logged;
+    {
+        lock_guard<mutex> lock(bookingMutex);
+        setFlightActive(index, false);
+        logged = wal.lastSequence();
+    }
+    wal.commit(logged);
+    return true;
+}
+
+bool FlightSystem::scheduleFlightById(const std::string& flightID) {
+    int index = findFlightIndex(flightID);
+    if (index < 0) return false;
+    uint64_t logged;
+    {
+        lock_guard<mutex> lock(bookingMutex);
+        setFlightActive(index, true);
+        logged = wal.lastSequence();
+    }
+    wal.commit(logged);
+    return true;
+}
+
+// Caller holds bookingMutex. Returns false if nothing changed.
+bool FlightSystem::setFlightActive(int flightIndex, bool active) {
+    Flight &f = flights[flightIndex];
+    if (f.active == active) return false;
+    if (active) searchIndex.add(f, flightIndex);
+    else searchIndex.remove(f, flightIndex);
+    invalidateSearch(f.source);
+    if (f.arrivalTime > f.departureTime) timetableDirty = true;
+    f.active = active;
+    wal.appendFlightState(f.flightID, active);
+    lock_guard<shared_mutex> graphLock(graphMutex);
+    if (active) graph.addEdge(f.source, f.destination, f.distance);
+    else graph.removeEdge(f.source, f.destination, f.distance);
+    return true;
+}
+
 void FlightSystem::viewFlights() {
-    cout << "Active flights (in-order by ID from BST):\n";
-    bst.displayInOrder();
+    cout << "Active flights (in-order by ID from index):\n";
+    lock_guard<mutex> lock(bookingMutex);
+    flightIndex.displayInOrder();
 }
 
 void FlightSystem::bookFlight() {
     string id, name;
     cout << "Enter Flight ID to book: ";
     cin >> id;
-    Flight* f = bst.search(id);
-    if (!f || !f->active) {
+    int index = findFlightIndex(id);
+    if (index < 0 || !flights[index].active.load(memory_order_relaxed)) {
         cout << "Flight not found or not active.\n";
         return;
     }
     cout << "Enter passenger name: ";
     cin >> name;
-    int index = -1;
-    for (int i = 0; i < flightCount; ++i) {
-        if (flights[i].flightID == id) {
-            index = i; break;
-        }
-    }
-    if (index == -1) {
-        cout << "Internal error: index not found.\n";
+    if (!bookingQueue.push({index, name})) {
+        cout << "Booking queue is full. Try again later.\n";
         return;
     }
-    bookingQueue.push(index);
     cout << "Booking request queued for " << id << ".\n";
 }
 
+bool FlightSystem::queueBooking(const std::string& flightID, const std::string& passengerName) {
+    int index = findFlightIndex(flightID);
+    if (index < 0 || !flights[index].active.load(memory_order_relaxed)) return false;
+    return bookingQueue.push({index, passengerName});
+}
+
+// Caller holds bookingMutex and has reserved the seat.
+int FlightSystem::addBooking(int flightIndex, const std::string& passengerName) {
+    int bookingId = bookings.add(flightIndex, passengerName);
+    wal.appendBooking(flights[flightIndex].flightID, bookingId, passengerName);
+    return bookingId;
+}
+
+// Caller holds bookingMutex. Returns the new booking ID, or 0 if the flight
+// is cancelled or full.
+int FlightSystem::confirmBooking(int flightIndex, const std::string& passengerName) {
+    if (!flights[flightIndex].active || !seatInventory.reserve(flightIndex, 1)) return 0;
+    return addBooking(flightIndex, passengerName);
+}
+
 void FlightSystem::processNextBooking() {
-    if (bookingQueue.empty()) {
-        cout << "No bookings to process.\n";
+    if (workerRunning.load()) {
+        cout << "Bookings are being processed by the booking worker.\n";
         return;
     }
-    int index = bookingQueue.front(); bookingQueue.pop();
-    Flight &f = flights[index];
-    if (!f.active) {
-        cout << "Flight " << f.flightID << " is cancelled. Cannot process booking.\n";
-        return;
+    BookingRequest req;
+    bool popped;
+    {
+        lock_guard<mutex> consumer(queueConsumerMutex);
+        popped = bookingQueue.pop(req);
     }
-    if (f.seats <= 0) {
-        cout << "No seats left on flight " << f.flightID << ".\n";
+    if (!popped) {
+        cout << "No bookings to process.\n";
         return;
     }
+    Flight &f = flights[req.flightIndex];
+    {
+        lock_guard<mutex> lock(bookingMutex);
+        if (!f.active) {
+            cout << "Flight " << f.flightID << " is cancelled. Cannot process booking.\n";
+            return;
+        }
+        if (seatInventory.available(req.flightIndex) <= 0) {
+            cout << "No seats left on flight " << f.flightID << ".\n";
+            return;
+        }
+    }
     string name;
     cout << "Processing booking for flight " << f.flightID << ". Enter passenger name: ";
     cin >> name;
-    f.seats--;
-    BookingNode* node = new BookingNode(globalBookingId++, name);
-    node->next = f.bookingHead;
-    f.bookingHead = node;
-    cout << "Booking confirmed for " << name << " on " << f.flightID
-         << ". Seats left: " << f.seats << "\n";
+    int bookingId;
+    uint64_t logged;
+    {
+        lock_guard<mutex> lock(bookingMutex);
+        bookingId = confirmBooking(req.flightIndex, name);
+        logged = wal.lastSequence();
+    }
+    if (bookingId == 0) {
+        cout << "Flight " << f.flightID << " is no longer available.\n";
+        return;
+    }
+    wal.commit(logged);
+    cout << "Booking " << bookingId << " confirmed for " << name << " on " << f.flightID
+         << ". Seats left: " << seatInventory.available(req.flightIndex) << "\n";
+}
+
+std::pair<bool, std::string> FlightSystem::processNextBookingNonInteractive(const std::string& passengerName) {
+    if (workerRunning.load()) return {false, "Bookings are being processed by the booking worker."};
+    BookingRequest req;
+    {
+        lock_guard<mutex> consumer(queueConsumerMutex);
+        if (!bookingQueue.pop(req)) return {false, "No bookings to process."};
+    }
+    Flight &f = flights[req.flightIndex];
+    const string& name = passengerName.empty() ? req.passengerName : passengerName;
+    int bookingId;
+    uint64_t logged;
+    {
+        lock_guard<mutex> lock(bookingMutex);
+        if (!f.active) return {false, "Flight " + f.flightID.str() + " is cancelled. Cannot process booking."};
+        bookingId = confirmBooking(req.flightIndex, name);
+        logged = wal.lastSequence();
+    }
+    if (bookingId == 0) return {false, "No seats left on flight " + f.flightID.str() + "."};
+    wal.commit(logged);
+    return {true, "Booking " + to_string(bookingId) + " confirmed for " + name + " on " + f.flightID.str()
+                  + ". Seats left: " + to_string(seatInventory.available(req.flightIndex))};
+}
+
+std::vector<int> FlightSystem::bookBatch(const std::vector<std::pair<std::string, std::string>>& requests) {
+    int n = static_cast<int>(requests.size());
+    vector<int> results(n, BOOKING_FLIGHT_NOT_FOUND);
+    vector<pair<int, int>> order;  // (flight index, request index)
+    order.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        int index = findFlightIndex(requests[i].first);
+        if (index >= 0) order.push_back({index, i});
+    }
+    sort(order.begin(), order.end());
+
+    unique_lock<mutex> lock(bookingMutex);
+    for (size_t begin = 0; begin < order.size();) {
+        int index = order[begin].first;
+        size_t end = begin;
+        while (end < order.size() && order[end].first == index) end++;
+        Flight &f = flights[index];
+        if (!f.active) {
+            for (size_t k = begin; k < end; ++k) results[order[k].second] = BOOKING_FLIGHT_INACTIVE;
+        } else {
+            int granted = seatInventory.reserveUpTo(index, static_cast<int>(end - begin));
+            bookings.reserve(index, granted);
+            for (size_t k = begin; k < end; ++k) {
+                int req = order[k].second;
+                results[req] = static_cast<int>(k - begin) < granted
+                    ? addBooking(index, requests[req].second)
+                    : BOOKING_SOLD_OUT;
+            }
+        }
+        begin = end;
+    }
+    uint64_t logged = wal.lastSequence();
+    lock.unlock();
+    wal.commit(logged);
+    return results;
+}
+
+void FlightSystem::startBookingWorker() {
+    if (workerRunning.exchange(true)) return;
+    workerStop.store(false);
+    bookingWorker = thread(&FlightSystem::bookingWorkerLoop, this);
+}
+
+void FlightSystem::stopBookingWorker() {
+    if (!workerRunning.load()) return;
+    workerStop.store(true);
+    bookingWorker.join();
+    workerRunning.store(false);
+}
+
+void FlightSystem::bookingWorkerLoop() {
+    const int BATCH = 256;
+    BookingRequest req;
+    int idle = 0;
+    for (;;) {
+        unique_lock<mutex> consumer(queueConsumerMutex);
+        if (bookingQueue.pop(req)) {
+            // Confirm a batch per lock acquisition so readers are not starved
+            // and the mutex is not taken once per booking.
+            uint64_t logged;
+            {
+                lock_guard<mutex> lock(bookingMutex);
+                int n = 0;
+                do {
+                    confirmBooking(req.flightIndex, req.passengerName);
+                } while (++n < BATCH && bookingQueue.pop(req));
+                logged = wal.lastSequence();
+            }
+            consumer.unlock();
+            wal.commit(logged);
+            idle = 0;
+            continue;
+        }
+        if (workerStop.load()) {
+            // Checked under queueConsumerMutex so no other consumer is midway
+            // through popping the last requests.
+            bool drained = bookingQueue.empty();
+            consumer.unlock();
+            if (drained) break;
+            continue;
+        }
+        consumer.unlock();
+        if (++idle < 64) this_thread::yield();
+        else this_thread::sleep_for(chrono::microseconds(100));
+    }
 }
 
 void FlightSystem::cancelBooking() {
@@ -427,73 +722,217 @@ void FlightSystem::cancelBooking() {
     cin >> id;
     cout << "Enter Booking ID to cancel: ";
     cin >> bid;
-    Flight* f = bst.search(id);
-    if (!f) {
+    int index = findFlightIndex(id);
+    if (index < 0) {
         cout << "Flight not found.\n";
         return;
     }
-    BookingNode* cur = f->bookingHead;
-    BookingNode* prev = nullptr;
-    while (cur && cur->bookingId != bid) {
-        prev = cur;
-        cur = cur->next;
-    }
-    if (!cur) {
+    if (!cancelBookingById(id, bid)) {
         cout << "Booking ID not found.\n";
         return;
     }
-    if (prev) prev->next = cur->next;
-    else f->bookingHead = cur->next;
-    delete cur;
-    f->seats++;
     cout << "Booking cancelled and seat restored on flight " << id << ".\n";
 }
 
+bool FlightSystem::cancelBookingById(const std::string& flightID, int bookingId) {
+    int index = findFlightIndex(flightID);
+    if (index < 0) return false;
+    uint64_t logged;
+    {
+        lock_guard<mutex> lock(bookingMutex);
+        if (!bookings.cancel(index, bookingId)) return false;
+        seatInventory.release(index, 1);
+        logged = wal.appendCancellation(flights[index].flightID, bookingId);
+    }
+    wal.commit(logged);
+    return true;
+}
+
+int FlightSystem::availableSeats(const std::string& flightID) const {
+    int index = findFlightIndex(flightID);
+    return index < 0 ? -1 : seatInventory.available(index);
+}
+
+uint64_t FlightSystem::holdSeats(const std::string& flightID, int count, int ttlMillis) {
+    int index = findFlightIndex(flightID);
+    if (index < 0) return 0;
+    return seatInventory.placeHold(index, count, ttlMillis);
+}
+
+// The held seats are already reserved, so confirming only checks the flight
+// is still active and writes the booking records. The hold is taken under
+// the lock so a snapshot never sees its seats gone without the bookings. A
+// cancelled flight gives the seats back and books nobody; a name count that
+// does not match leaves the hold untouched.
+std::vector<int> FlightSystem::confirmHoldBooking(uint64_t holdId, const std::vector<std::string>& passengerNames) {
+    vector<int> ids;
+    uint64_t logged;
+    {
+        lock_guard<mutex> lock(bookingMutex);
+        int index = -1;
+        int count = seatInventory.confirmHold(holdId, static_cast<int>(passengerNames.size()), &index);
+        if (count == 0) return ids;
+        if (!flights[index].active) {
+            seatInventory.release(index, count);
+            return ids;
+        }
+        bookings.reserve(index, count);
+        ids.reserve(count);
+        for (const string& name : passengerNames) ids.push_back(addBooking(index, name));
+        logged = wal.lastSequence();
+    }
+    wal.commit(logged);
+    return ids;
+}
+
+bool FlightSystem::releaseHold(uint64_t holdId) {
+    return seatInventory.releaseHold(holdId) > 0;
+}
+
+int FlightSystem::expireHolds() {
+    return seatInventory.expireHolds();
+}
+
 void FlightSystem::showBookingsForFlight() {
     string id;
     cout << "Enter Flight ID: ";
     cin >> id;
-    Flight* f = bst.search(id);
-    if (!f) {
+    int index = findFlightIndex(id);
+    if (index < 0) {
         cout << "Flight not found.\n";
         return;
     }
     cout << "Bookings for flight " << id << ":\n";
-    BookingNode* cur = f->bookingHead;
-    if (!cur) {
+    lock_guard<mutex> lock(bookingMutex);
+    if (bookings.liveCount(index) == 0) {
         cout << "No bookings.\n";
         return;
     }
-    while (cur) {
-        cout << "BookingID: " << cur->bookingId
-             << ", Name: " << cur->passengerName << "\n";
-        cur = cur->next;
-    }
+    bookings.forEach(index, [](const BookingRecord& r) {
+        cout << "BookingID: " << r.bookingId
+             << ", Name: " << r.passengerName << "\n";
+    });
+}
+
+std::vector<std::pair<int, std::string>> FlightSystem::getBookingsForFlight(const std::string& flightID) const {
+    vector<pair<int, string>> out;
+    int index = findFlightIndex(flightID);
+    if (index < 0) return out;
+    lock_guard<mutex> lock(bookingMutex);
+    out.reserve(bookings.liveCount(index));
+    bookings.forEach(index, [&out](const BookingRecord& r) {
+        out.push_back({r.bookingId, r.passengerName});
+    });
+    return out;
 }
 
 void FlightSystem::searchFlightsBySource() {
-    string src;
+    string name;
     cout << "Enter source: ";
-    cin >> src;
-    bool found = false;
-    for (int i = 0; i < flightCount; ++i) {
-        Flight &f = flights[i];
-        if (f.source == src && f.active) {
-            cout << f.flightID << ": " << f.source << " -> " << f.destination
-                 << ", Dist: " << f.distance << ", Seats: " << f.seats << "\n";
-            recentSearches.push(src);
-            found = true;
+    cin >> name;
+    AirportCode src = toAirport(name);
+    SlotSpan matches = searchIndex.bySource(src);
+    for (int slot : matches) {
+        const Flight &f = flights[slot];
+        cout << f.flightID << ": " << f.source << " -> " << f.destination
+             << ", Dist: " << f.distance << ", Seats: " << f.seats.load() << "\n";
+    }
+    if (matches.empty()) {
+        cout << "No active flights from this source.\n";
+        return;
+    }
+    lock_guard<mutex> lock(searchMutex);
+    recentSearches.record(src);
+}
+
+SlotSpan FlightSystem::flightsFromSource(const std::string& source) const {
+    return searchIndex.bySource(toAirport(source));
+}
+
+SlotSpan FlightSystem::flightsToDestination(const std::string& destination) const {
+    return searchIndex.byDestination(toAirport(destination));
+}
+
+SlotSpan FlightSystem::searchFlightsByRoute(const std::string& source, const std::string& destination) const {
+    return searchIndex.byRoute(toAirport(source), toAirport(destination));
+}
+
+std::vector<Flight> FlightSystem::flightsToDestinationList(const std::string& destination) const {
+    AirportCode dst = toAirport(destination);
+    lock_guard<mutex> lock(bookingMutex);
+    SlotSpan matches = searchIndex.byDestination(dst);
+    vector<Flight> out;
+    out.reserve(matches.size());
+    for (int slot : matches) out.push_back(flights[slot]);
+    return out;
+}
+
+std::vector<Flight> FlightSystem::searchFlightsByRouteList(const std::string& source, const std::string& destination) const {
+    AirportCode src = toAirport(source), dst = toAirport(destination);
+    lock_guard<mutex> lock(bookingMutex);
+    SlotSpan matches = searchIndex.byRoute(src, dst);
+    vector<Flight> out;
+    out.reserve(matches.size());
+    for (int slot : matches) out.push_back(flights[slot]);
+    return out;
+}
+
+// Caller holds bookingMutex, so no search can be
+// rebuilding the entry being dropped.
+void FlightSystem::invalidateSearch(AirportCode source) {
+    lock_guard<mutex> lock(searchMutex);
+    recentSearches.invalidate(source);
+}
+
+// Hot sources are answered from the result memoized in their history entry;
+// only seat counts, which change with every booking, are re-read. A miss is
+// built from the search index and stored under bookingMutex, which also
+// guards every invalidation, so a stale result is never cached.
+std::vector<Flight> FlightSystem::searchFlightsBySourceNonInteractive(const std::string& source) {
+    AirportCode src = toAirport(source);
+    {
+        lock_guard<mutex> lock(searchMutex);
+        if (const SearchResult* hit = recentSearches.cached(src)) {
+            vector<Flight> out = hit->flights;
+            for (size_t i = 0; i < out.size(); ++i) out[i].seats.store(seatInventory.available(hit->slots[i]));
+            recentSearches.record(src);
+            return out;
         }
     }
-    if (!found) cout << "No active flights from this source.\n";
+    lock_guard<mutex> lock(bookingMutex);
+    SlotSpan matches = searchIndex.bySource(src);
+    SearchResult result;
+    result.slots.assign(matches.begin(), matches.end());
+    result.flights.reserve(matches.size());
+    for (int slot : matches) result.flights.push_back(flights[slot]);
+    vector<Flight> out = result.flights;
+    if (!out.empty()) {
+        lock_guard<mutex> cacheLock(searchMutex);
+        recentSearches.record(src);
+        recentSearches.store(src, std::move(result));
+    }
+    return out;
+}
+
+std::vector<std::string> FlightSystem::recentSearchesList() const {
+    lock_guard<mutex> lock(searchMutex);
+    vector<string> out;
+    for (AirportCode src : recentSearches.recent()) out.push_back(src.str());
+    return out;
+}
+
+std::vector<std::pair<std::string, int>> FlightSystem::topSearches(int k) const {
+    lock_guard<mutex> lock(searchMutex);
+    vector<pair<string, int>> out;
+    for (const auto& entry : recentSearches.top(k)) out.push_back({entry.first.str(), entry.second});
+    return out;
 }
 
 void FlightSystem::showRecentSearches() {
-    cout << "Recent search sources (stack top to bottom): ";
-    stack<string> temp = recentSearches;
-    while (!temp.empty()) {
-        cout << temp.top() << " ";
-        temp.pop();
+    cout << "Recent search sources (most recent first, with search counts): ";
+    lock_guard<mutex> lock(searchMutex);
+    for (AirportCode src : recentSearches.recent()) {
+        cout << src << "(" << recentSearches.count(src) << ") ";
     }
     cout << "\n";
 }
@@ -504,30 +943,207 @@ void FlightSystem::shortestDistanceBetweenAirports() {
     cin >> a;
     cout << "Enter destination airport: ";
     cin >> b;
-    graph.dijkstra(a, b);
+    lock_guard<shared_mutex> lock(graphMutex);
+    graph.dijkstra(toAirport(a), toAirport(b));
+}
+
+// Queries share the graph lock; only the first one after a change takes it
+// exclusively to rebuild the snapshot.
+std::pair<int, std::vector<std::string>> FlightSystem::dijkstraPath(const std::string& src, const std::string& dest,
+                                                                  RouteMode mode) {
+    auto toNames = [](const std::pair<int, std::vector<AirportCode>>& route) {
+        vector<string> names;
+        names.reserve(route.second.size());
+        for (AirportCode code : route.second) names.push_back(code.str());
+        return std::pair<int, std::vector<std::string>>(route.first, names);
+    };
+    {
+        shared_lock<shared_mutex> lock(graphMutex);
+        if (graph.queriesPrepared()) return toNames(graph.findRoute(toAirport(src), toAirport(dest), mode));
+    }
+    lock_guard<shared_mutex> lock(graphMutex);
+    return toNames(graph.shortestPath(toAirport(src), toAirport(dest), mode));
+}
+
+std::vector<std::string> FlightSystem::dfsOrder(const std::string& start, int maxDepth) {
+    lock_guard<shared_mutex> lock(graphMutex);
+    vector<int> order;
+    graph.depthFirst(toAirport(start), order, maxDepth);
+    vector<string> names;
+    names.reserve(order.size());
+    for (int u : order) names.push_back(graph.airportAt(u).str());
+    return names;
+}
+
+std::vector<std::string> FlightSystem::bfsOrder(const std::string& start, int maxDepth) {
+    lock_guard<shared_mutex> lock(graphMutex);
+    vector<int> order;
+    graph.breadthFirst(toAirport(start), order, maxDepth);
+    vector<string> names;
+    names.reserve(order.size());
+    for (int u : order) names.push_back(graph.airportAt(u).str());
+    return names;
+}
+
+std::vector<std::pair<std::string, int>> FlightSystem::reachableAirports(const std::string& start, int maxDepth) {
+    lock_guard<shared_mutex> lock(graphMutex);
+    vector<int> depth;
+    int reached = graph.reachableFrom(toAirport(start), depth, maxDepth);
+    vector<pair<string, int>> out;
+    out.reserve(reached);
+    for (size_t u = 0; u < depth.size(); ++u) {
+        if (depth[u] >= 0) out.push_back({graph.airportAt(static_cast<int>(u)).str(), depth[u]});
+    }
+    return out;
+}
+
+bool FlightSystem::airportsConnected(const std::string& a, const std::string& b) {
+    lock_guard<shared_mutex> lock(graphMutex);
+    return graph.connected(toAirport(a), toAirport(b));
+}
+
+int FlightSystem::componentSize(const std::string& airport) {
+    lock_guard<shared_mutex> lock(graphMutex);
+    return graph.componentSize(toAirport(airport));
+}
+
+std::vector<std::vector<std::string>> FlightSystem::connectedComponents() {
+    lock_guard<shared_mutex> lock(graphMutex);
+    vector<vector<string>> out;
+    for (const vector<AirportCode>& group : graph.components()) {
+        out.emplace_back();
+        out.back().reserve(group.size());
+        for (AirportCode code : group) out.back().push_back(code.str());
+    }
+    return out;
+}
+
+std::vector<std::tuple<std::string, std::string, int>> FlightSystem::minimumSpanningForest(int threads) {
+    lock_guard<shared_mutex> lock(graphMutex);
+    SpanningForest forest = graph.boruvkaForest(threads);
+    vector<tuple<string, string, int>> out;
+    out.reserve(forest.edges.size());
+    for (const SpanningEdge& e : forest.edges) out.emplace_back(e.from.str(), e.to.str(), e.distance);
+    return out;
+}
+
+std::vector<std::pair<int, std::vector<std::string>>> FlightSystem::alternativeRoutes(
+    const std::string& src, const std::string& dest, int k, int maxLegs, const std::vector<std::string>& excluded) {
+    vector<AirportCode> avoid;
+    avoid.reserve(excluded.size());
+    for (const string& name : excluded) avoid.push_back(toAirport(name));
+    auto toNames = [](const vector<Itinerary>& itineraries) {
+        vector<pair<int, vector<string>>> routes;
+        routes.reserve(itineraries.size());
+        for (const Itinerary& it : itineraries) {
+            vector<string> names;
+            names.reserve(it.airports.size());
+            for (AirportCode code : it.airports) names.push_back(code.str());
+            routes.push_back({it.distance, std::move(names)});
+        }
+        return routes;
+    };
+    {
+        shared_lock<shared_mutex> lock(graphMutex);
+        if (graph.queriesPrepared()) return toNames(graph.findItineraries(toAirport(src), toAirport(dest), k, maxLegs, avoid));
+    }
+    lock_guard<shared_mutex> lock(graphMutex);
+    return toNames(graph.kShortestPaths(toAirport(src), toAirport(dest), k, maxLegs, avoid));
+}
+
+std::pair<int64_t, std::vector<std::string>> FlightSystem::earliestArrival(const std::string& src,
+                                                                          const std::string& dest,
+                                                                          int64_t departAfter) {
+    auto toIds = [this](const Journey& journey) {
+        vector<string> ids;
+        ids.reserve(journey.flights.size());
+        for (int slot : journey.flights) ids.push_back(flights[slot].flightID.str());
+        return std::pair<int64_t, std::vector<std::string>>(journey.arrival, ids);
+    };
+    {
+        shared_lock<shared_mutex> lock(timetableMutex);
+        if (!timetableDirty) return toIds(timetable.earliestArrival(toAirport(src), toAirport(dest), departAfter));
+    }
+    lock_guard<mutex> bookingLock(bookingMutex);
+    lock_guard<shared_mutex> lock(timetableMutex);
+    if (timetableDirty.exchange(false)) timetable.build(flights);
+    return toIds(timetable.earliestArrival(toAirport(src), toAirport(dest), departAfter));
+}
+
+void FlightSystem::setDefaultConnectionTime(int seconds) {
+    lock_guard<shared_mutex> lock(timetableMutex);
+    timetable.setDefaultConnectionTime(seconds);
+}
+
+bool FlightSystem::setMinimumConnectionTime(const std::string& airport, int seconds) {
+    AirportCode code;
+    if (!AirportCode::parse(airport, code) || code.empty()) return false;
+    lock_guard<shared_mutex> lock(timetableMutex);
+    timetable.setMinimumConnectionTime(code, seconds);
+    return true;
+}
+
+bool FlightSystem::publishSchedule() {
+    lock_guard<shared_mutex> lock(graphMutex);
+    if (graph.hierarchyCurrent()) return false;
+    graph.buildHierarchy();
+    return true;
+}
+
+void FlightSystem::computeDistanceMatrix(int threads) {
+    lock_guard<shared_mutex> lock(graphMutex);
+    graph.computeAllPairs(threads);
+}
+
+int FlightSystem::refreshDistanceMatrix(int threads) {
+    lock_guard<shared_mutex> lock(graphMutex);
+    return graph.refreshAllPairs(threads);
+}
+
+DistanceMatrix FlightSystem::distanceMatrix() const {
+    lock_guard<shared_mutex> lock(graphMutex);
+    return graph.allPairs();
+}
+
+std::vector<std::string> FlightSystem::matrixAirports() const {
+    lock_guard<shared_mutex> lock(graphMutex);
+    vector<string> names;
+    int n = graph.allPairs().size();
+    names.reserve(n);
+    for (int i = 0; i < n; ++i) names.push_back(graph.airportAt(i).str());
+    return names;
+}
+
+bool FlightSystem::setAirportCoordinates(const std::string& airport, double latitude, double longitude) {
+    lock_guard<shared_mutex> lock(graphMutex);
+    return graph.setAirportCoordinates(toAirport(airport), latitude, longitude);
 }
 
 void FlightSystem::runDFS() {
     string a;
     cout << "Enter start airport for DFS: ";
     cin >> a;
-    graph.DFS(a);
+    lock_guard<shared_mutex> lock(graphMutex);
+    graph.DFS(toAirport(a));
 }
 
 void FlightSystem::runBFS() {
     string a;
     cout << "Enter start airport for BFS: ";
     cin >> a;
-    graph.BFS(a);
+    lock_guard<shared_mutex> lock(graphMutex);
+    graph.BFS(toAirport(a));
 }
 
 void FlightSystem::runPrimMST() {
     string a;
     cout << "Enter start airport for Prim's MST: ";
     cin >> a;
-    graph.primMST(a);
+    lock_guard<shared_mutex> lock(graphMutex);
+    graph.primMST(toAirport(a));
 }
 
 void FlightSystem::runKruskalMST() {
+    lock_guard<shared_mutex> lock(graphMutex);
     graph.kruskalMST();
 }
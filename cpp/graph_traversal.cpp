@@ -0,0 +1,134 @@
+#include "fms.h"
+#include <climits>
+#include <utility>
+
+using namespace std;
+
+namespace {
+// Direction switches from Beamer et al.: go bottom-up once the frontier's
+// arcs exceed 1/ALPHA of the arcs still unexplored, and back top-down once
+// the frontier holds fewer than 1/BETA of the airports.
+const long long ALPHA = 14;
+const long long BETA = 24;
+}
+
+int AirportGraph::depthFirst(AirportCode start, std::vector<int>& order, int maxDepth,
+                             const TraversalVisitor& visit) {
+    order.clear();
+    auto it = airportIndex.find(start);
+    if (it == airportIndex.end()) return 0;
+    const CsrGraph& g = snapshot();
+    DijkstraContext& ctx = DijkstraContext::local();
+    SearchLabels& seen = ctx.labels[0];
+    vector<pair<int, int>>& stack = ctx.dfsStack;
+    seen.reset(g.nodeCount());
+    stack.clear();
+
+    int s = it->second;
+    seen.set(s, 0, -1);
+    order.push_back(s);
+    if (visit && !visit(s, 0)) return 1;
+    stack.push_back({s, g.begin(s)});
+    // The top of the stack is the airport being expanded and the next arc to
+    // try; its depth is its position in the stack.
+    while (!stack.empty()) {
+        int u = stack.back().first;
+        int depth = static_cast<int>(stack.size()) - 1;
+        int& e = stack.back().second;
+        if (e == g.end(u) || depth == maxDepth) {
+            stack.pop_back();
+            continue;
+        }
+        int v = g.targets[e++];
+        if (seen.dist(v) != INT_MAX) continue;
+        seen.set(v, depth + 1, u);
+        order.push_back(v);
+        if (visit && !visit(v, depth + 1)) break;
+        stack.push_back({v, g.begin(v)});
+    }
+    return static_cast<int>(order.size());
+}
+
+// order doubles as the queue: airports are appended when discovered and
+// expanded in that same order.
+int AirportGraph::breadthFirst(AirportCode start, std::vector<int>& order, int maxDepth,
+                               const TraversalVisitor& visit) {
+    order.clear();
+    auto it = airportIndex.find(start);
+    if (it == airportIndex.end()) return 0;
+    const CsrGraph& g = snapshot();
+    SearchLabels& seen = DijkstraContext::local().labels[0];
+    seen.reset(g.nodeCount());
+
+    int s = it->second;
+    seen.set(s, 0, -1);
+    order.push_back(s);
+    if (visit && !visit(s, 0)) return 1;
+    for (size_t head = 0; head < order.size(); ++head) {
+        int u = order[head];
+        int depth = seen.dist(u);
+        if (depth == maxDepth) continue;
+        for (int e = g.begin(u); e < g.end(u); ++e) {
+            int v = g.targets[e];
+            if (seen.dist(v) != INT_MAX) continue;
+            seen.set(v, depth + 1, u);
+            order.push_back(v);
+            if (visit && !visit(v, depth + 1)) return static_cast<int>(order.size());
+        }
+    }
+    return static_cast<int>(order.size());
+}
+
+int AirportGraph::reachableFrom(AirportCode start, std::vector<int>& depth, int maxDepth) {
+    auto it = airportIndex.find(start);
+    const CsrGraph& g = snapshot();
+    int n = g.nodeCount();
+    depth.assign(n, -1);
+    if (it == airportIndex.end()) return 0;
+    DijkstraContext& ctx = DijkstraContext::local();
+    vector<int>& frontier = ctx.frontier[0];
+    vector<int>& next = ctx.frontier[1];
+    frontier.clear();
+
+    int s = it->second;
+    depth[s] = 0;
+    frontier.push_back(s);
+    long long frontierArcs = g.end(s) - g.begin(s);
+    long long unexploredArcs = static_cast<long long>(g.targets.size()) - frontierArcs;
+    int reached = 1;
+    bool bottomUp = false;
+    for (int level = 0; !frontier.empty() && level != maxDepth; ++level) {
+        if (!bottomUp && frontierArcs > unexploredArcs / ALPHA) bottomUp = true;
+        else if (bottomUp && static_cast<long long>(frontier.size()) < n / BETA) bottomUp = false;
+
+        next.clear();
+        if (bottomUp) {
+            for (int v = 0; v < n; ++v) {
+                if (depth[v] != -1) continue;
+                for (int e = g.begin(v); e < g.end(v); ++e) {
+                    if (depth[g.targets[e]] == level) {
+                        depth[v] = level + 1;
+                        next.push_back(v);
+                        break;
+                    }
+                }
+            }
+        } else {
+            for (int u : frontier) {
+                for (int e = g.begin(u); e < g.end(u); ++e) {
+                    int v = g.targets[e];
+                    if (depth[v] == -1) {
+                        depth[v] = level + 1;
+                        next.push_back(v);
+                    }
+                }
+            }
+        }
+        frontierArcs = 0;
+        for (int v : next) frontierArcs += g.end(v) - g.begin(v);
+        unexploredArcs -= frontierArcs;
+        reached += static_cast<int>(next.size());
+        swap(frontier, next);
+    }
+    return reached;
+}
@@ -0,0 +1,216 @@
+#include "fms.h"
+#include <algorithm>
+#include <climits>
+#include <set>
+
+using namespace std;
+
+namespace {
+// Yen's K shortest loopless paths on a CSR snapshot. One reverse Dijkstra
+// from the target gives every airport its exact distance to the target, and
+// one reverse BFS its fewest legs to the target. Spur searches are A* with
+// that distance as the potential: where the rest of the shortest-path tree
+// is still usable they walk straight down it, and they only spread out
+// around blocked airports and routes. The leg count is part of the search
+// state, so a path that is longer but has fewer legs still counts when
+// maxLegs is set.
+class YenSearch {
+public:
+    YenSearch(const CsrGraph& g, int t, int maxLegs, const vector<int>& excluded)
+        : g(g), t(t), maxLegs(maxLegs), n(g.nodeCount()), toTarget(n, INT_MAX), legsToTarget(n, INT_MAX),
+          blocked(n, 0), blockEpoch(1), settledLegs(n, 0), settledStamp(n, 0), searchEpoch(0),
+          labels(), heap() {
+        for (int v : excluded) blocked[v] = UINT32_MAX;
+        if (blocked[t] == UINT32_MAX) return;
+        toTarget[t] = 0;
+        heap.push(0, t);
+        while (!heap.empty()) {
+            auto [d, u] = heap.top(); heap.pop();
+            if (d != toTarget[u]) continue;
+            for (int e = g.begin(u); e < g.end(u); ++e) {
+                int v = g.targets[e], nd = d + g.weights[e];
+                if (blocked[v] != UINT32_MAX && nd < toTarget[v]) {
+                    toTarget[v] = nd;
+                    heap.push(nd, v);
+                }
+            }
+        }
+        vector<int> frontier{t};
+        legsToTarget[t] = 0;
+        for (size_t i = 0; i < frontier.size(); ++i) {
+            int u = frontier[i];
+            for (int e = g.begin(u); e < g.end(u); ++e) {
+                int v = g.targets[e];
+                if (blocked[v] != UINT32_MAX && legsToTarget[v] == INT_MAX) {
+                    legsToTarget[v] = legsToTarget[u] + 1;
+                    frontier.push_back(v);
+                }
+            }
+        }
+    }
+
+    int distanceToTarget(int v) const { return toTarget[v]; }
+
+    // Blocks are cleared together; excluded airports stay blocked.
+    void clearBlocks() { blockEpoch++; }
+    void block(int v) {
+        if (blocked[v] != UINT32_MAX) blocked[v] = blockEpoch;
+    }
+
+    // Shortest path from spur to the target that avoids blocked airports and
+    // the routes spur -> forbidden[i], given `legs` legs already used. Gives
+    // up on anything not shorter than `bound` (measured from spur). Returns
+    // the distance (INT_MAX if none) and fills path, spur first.
+    int search(int spur, int legs, const vector<int>& forbidden, long long bound, vector<int>& path) {
+        path.clear();
+        if (blocked[spur] == UINT32_MAX || toTarget[spur] == INT_MAX || !withinLegs(spur, legs)) return INT_MAX;
+        if (++searchEpoch == 0) {
+            fill(settledStamp.begin(), settledStamp.end(), 0);
+            searchEpoch = 1;
+        }
+        labels.clear();
+        heap.clear();
+        labels.push_back({spur, legs, 0, -1});
+        heap.push(toTarget[spur], 0);
+        while (!heap.empty()) {
+            int index = heap.top().second;
+            heap.pop();
+            Label label = labels[index];
+            int u = label.node;
+            // Labels for u come off in order of distance, so one with no
+            // fewer legs than an earlier one can never do better.
+            if (settledStamp[u] == searchEpoch && settledLegs[u] <= label.legs) continue;
+            settledStamp[u] = searchEpoch;
+            settledLegs[u] = label.legs;
+            if (u == t) {
+                for (int i = index; i != -1; i = labels[i].parent) path.push_back(labels[i].node);
+                reverse(path.begin(), path.end());
+                return label.dist;
+            }
+            for (int e = g.begin(u); e < g.end(u); ++e) {
+                int v = g.targets[e];
+                int nextLegs = maxLegs > 0 ? label.legs + 1 : 0;
+                if (blocked[v] == blockEpoch || blocked[v] == UINT32_MAX || toTarget[v] == INT_MAX) continue;
+                if (!withinLegs(v, nextLegs)) continue;
+                if (settledStamp[v] == searchEpoch && settledLegs[v] <= nextLegs) continue;
+                if (u == spur && find(forbidden.begin(), forbidden.end(), v) != forbidden.end()) continue;
+                long long nd = static_cast<long long>(label.dist) + g.weights[e];
+                if (nd + toTarget[v] >= bound) continue;
+                labels.push_back({v, nextLegs, static_cast<int>(nd), index});
+                heap.push(static_cast<int>(nd + toTarget[v]), static_cast<int>(labels.size() - 1));
+            }
+        }
+        return INT_MAX;
+    }
+
+private:
+    struct Label {
+        int node;
+        int legs;
+        int dist;
+        int parent;  // index into labels
+    };
+
+    bool withinLegs(int v, int legs) const {
+        return maxLegs <= 0 || (legsToTarget[v] != INT_MAX && legs + legsToTarget[v] <= maxLegs);
+    }
+
+    const CsrGraph& g;
+    int t;
+    int maxLegs;
+    int n;
+    vector<int> toTarget;
+    vector<int> legsToTarget;
+    vector<uint32_t> blocked;  // blockEpoch: blocked now; UINT32_MAX: excluded
+    uint32_t blockEpoch;
+    vector<int> settledLegs;
+    vector<uint32_t> settledStamp;
+    uint32_t searchEpoch;
+    vector<Label> labels;
+    RadixHeap heap;
+};
+
+int routeWeight(const CsrGraph& g, int u, int v) {
+    for (int e = g.begin(u); e < g.end(u); ++e) {
+        if (g.targets[e] == v) return g.weights[e];
+    }
+    return INT_MAX;
+}
+}
+
+std::vector<Itinerary> AirportGraph::kShortestPaths(AirportCode source, AirportCode dest, int k, int maxLegs,
+                                                    const std::vector<AirportCode>& excluded) {
+    prepareQueries();
+    return findItineraries(source, dest, k, maxLegs, excluded);
+}
+
+std::vector<Itinerary> AirportGraph::findItineraries(AirportCode source, AirportCode dest, int k, int maxLegs,
+                                                     const std::vector<AirportCode>& excluded) const {
+    auto a = airportIndex.find(source), b = airportIndex.find(dest);
+    if (k <= 0 || a == airportIndex.end() || b == airportIndex.end()) return {};
+    int s = a->second, t = b->second;
+    vector<int> excludedIdx;
+    for (AirportCode code : excluded) {
+        auto it = airportIndex.find(code);
+        if (it == airportIndex.end()) continue;
+        if (it->second == s || it->second == t) return {};
+        excludedIdx.push_back(it->second);
+    }
+
+    vector<pair<int, vector<int>>> found;
+    if (s == t) {
+        found.push_back({0, {s}});
+    } else {
+        const CsrGraph& g = csr;
+        YenSearch yen(g, t, maxLegs, excludedIdx);
+        vector<int> spurPath;
+        int first = yen.search(s, 0, {}, LLONG_MAX, spurPath);
+        if (first != INT_MAX) found.push_back({first, spurPath});
+        // Candidates ordered by (distance, path); the set also drops
+        // duplicates. Only the best k - found.size() can still be needed.
+        set<pair<int, vector<int>>> candidates;
+        vector<int> forbidden;
+        while (!found.empty() && static_cast<int>(found.size()) < k) {
+            const vector<int>& last = found.back().second;
+            size_t needed = k - found.size();
+            yen.clearBlocks();
+            long long rootDist = 0;
+            for (size_t i = 0; i + 1 < last.size(); ++i) {
+                int spur = last[i];
+                forbidden.clear();
+                for (const auto& path : found) {
+                    const vector<int>& p = path.second;
+                    if (p.size() > i + 1 && equal(last.begin(), last.begin() + i + 1, p.begin())) {
+                        forbidden.push_back(p[i + 1]);
+                    }
+                }
+                long long bound = LLONG_MAX;
+                if (candidates.size() >= needed) bound = prev(candidates.end())->first - rootDist;
+                if (bound > yen.distanceToTarget(spur)) {
+                    int spurDist = yen.search(spur, maxLegs > 0 ? static_cast<int>(i) : 0, forbidden, bound, spurPath);
+                    if (spurDist != INT_MAX && rootDist + spurDist <= INT_MAX) {
+                        vector<int> candidate(last.begin(), last.begin() + i);
+                        candidate.insert(candidate.end(), spurPath.begin(), spurPath.end());
+                        candidates.insert({static_cast<int>(rootDist + spurDist), std::move(candidate)});
+                        if (candidates.size() > needed) candidates.erase(prev(candidates.end()));
+                    }
+                }
+                yen.block(spur);
+                rootDist += routeWeight(g, spur, last[i + 1]);
+            }
+            if (candidates.empty()) break;
+            found.push_back(std::move(*candidates.begin()));
+            candidates.erase(candidates.begin());
+        }
+    }
+
+    vector<Itinerary> result;
+    result.reserve(found.size());
+    for (const auto& path : found) {
+        Itinerary itinerary{path.first, {}};
+        itinerary.airports.reserve(path.second.size());
+        for (int idx : path.second) itinerary.airports.push_back(indexToAirport[idx]);
+        result.push_back(std::move(itinerary));
+    }
+    return result;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Runs fn(i) for every i in [begin, end) on up to `threads` threads (0 means
+// one per hardware thread); the calling thread is one of them. Indices are
+// handed out `chunk` at a time from a shared counter, so uneven items balance
+// themselves. fn must be safe to call concurrently for different i.
+template <class Fn>
+void parallelFor(int begin, int end, Fn fn, int threads = 0, int chunk = 1) {
+    if (end <= begin) return;
+    if (threads <= 0) threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    chunk = std::max(1, chunk);
+    threads = std::min(threads, (end - begin + chunk - 1) / chunk);
+
+    std::atomic<int> nextIndex(begin);
+    auto work = [&]() {
+        for (;;) {
+            int first = nextIndex.fetch_add(chunk, std::memory_order_relaxed);
+            if (first >= end) return;
+            int last = std::min(end, first + chunk);
+            for (int i = first; i < last; ++i) fn(i);
+        }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (int t = 1; t < threads; ++t) workers.emplace_back(work);
+    work();
+    for (std::thread& w : workers) w.join();
+}
+
+// Sorts [first, last) with comp on up to `threads` threads (0 means one per
+// hardware thread): equal slices are sorted in parallel, then merged pairwise
+// in rounds, each round's merges also in parallel. Ranges too small to split
+// usefully are sorted on the calling thread.
+template <class It, class Compare>
+void parallelSort(It first, It last, Compare comp, int threads = 0) {
+    const long long MIN_SLICE = 1 << 15;
+    long long n = last - first;
+    if (threads <= 0) threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int slices = static_cast<int>(std::min<long long>(threads, n / MIN_SLICE));
+    if (slices <= 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+    std::vector<It> bound(slices + 1);
+    for (int i = 0; i <= slices; ++i) bound[i] = first + n * i / slices;
+    parallelFor(0, slices, [&](int i) { std::sort(bound[i], bound[i + 1], comp); }, slices);
+    for (int width = 1; width < slices; width *= 2) {
+        int merges = (slices + 2 * width - 1) / (2 * width);
+        parallelFor(0, merges, [&](int i) {
+            int lo = 2 * i * width, mid = lo + width, hi = std::min(slices, lo + 2 * width);
+            if (mid < hi) std::inplace_merge(bound[lo], bound[mid], bound[hi], comp);
+        }, slices);
+    }
+}
@@ -0,0 +1,110 @@
+#include "fms.h"
+#include <algorithm>
+
+using namespace std;
+
+SearchHistory::SearchHistory(int capacity)
+    : entries(max(capacity, 1)), slots(), head(-1), tail(-1) {
+    slots.reserve(entries.size());
+}
+
+void SearchHistory::unlink(int i) {
+    Entry& e = entries[i];
+    if (e.prev >= 0) entries[e.prev].next = e.next;
+    else head = e.next;
+    if (e.next >= 0) entries[e.next].prev = e.prev;
+    else tail = e.prev;
+}
+
+void SearchHistory::pushFront(int i) {
+    Entry& e = entries[i];
+    e.prev = -1;
+    e.next = head;
+    if (head >= 0) entries[head].prev = i;
+    head = i;
+    if (tail < 0) tail = i;
+}
+
+void SearchHistory::record(AirportCode source) {
+    auto it = slots.find(source);
+    if (it != slots.end()) {
+        int i = it->second;
+        entries[i].count++;
+        if (i != head) {
+            unlink(i);
+            pushFront(i);
+        }
+        return;
+    }
+    int i;
+    if (size() < capacity()) {
+        i = size();
+    } else {
+        i = tail;
+        unlink(i);
+        slots.erase(entries[i].source);
+    }
+    Entry& e = entries[i];
+    e.source = source;
+    e.count = 1;
+    e.hasResult = false;
+    e.result = SearchResult();
+    slots[source] = i;
+    pushFront(i);
+}
+
+int SearchHistory::count(AirportCode source) const {
+    auto it = slots.find(source);
+    return it == slots.end() ? 0 : entries[it->second].count;
+}
+
+std::vector<AirportCode> SearchHistory::recent() const {
+    vector<AirportCode> out;
+    out.reserve(slots.size());
+    for (int i = head; i >= 0; i = entries[i].next) out.push_back(entries[i].source);
+    return out;
+}
+
+// Ties go to the more recent source.
+std::vector<std::pair<AirportCode, int>> SearchHistory::top(int k) const {
+    vector<pair<AirportCode, int>> out;
+    out.reserve(slots.size());
+    for (int i = head; i >= 0; i = entries[i].next) out.push_back({entries[i].source, entries[i].count});
+    stable_sort(out.begin(), out.end(), [](const pair<AirportCode, int>& a, const pair<AirportCode, int>& b) {
+        return a.second > b.second;
+    });
+    out.resize(max(0, min(k, static_cast<int>(out.size()))));
+    return out;
+}
+
+const SearchResult* SearchHistory::cached(AirportCode source) const {
+    auto it = slots.find(source);
+    if (it == slots.end() || !entries[it->second].hasResult) return nullptr;
+    return &entries[it->second].result;
+}
+
+void SearchHistory::store(AirportCode source, SearchResult result) {
+    auto it = slots.find(source);
+    if (it == slots.end()) return;
+    Entry& e = entries[it->second];
+    e.result = std::move(result);
+    e.hasResult = true;
+}
+
+void SearchHistory::invalidate(AirportCode source) {
+    auto it = slots.find(source);
+    if (it == slots.end()) return;
+    Entry& e = entries[it->second];
+    e.hasResult = false;
+    e.result = SearchResult();
+}
+
+void SearchHistory::clear() {
+    for (Entry& e : entries) {
+        e.hasResult = false;
+        e.result = SearchResult();
+    }
+    slots.clear();
+    head = -1;
+    tail = -1;
+}
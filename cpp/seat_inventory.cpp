@@ -0,0 +1,150 @@
+#include "fms.h"
+
+using namespace std;
+
+SeatInventory::SeatInventory(FlightStore& store)
+    : flights(store), stripes(new Stripe[STRIPES]), nextHold(1) {}
+
+int SeatInventory::available(int slot) const {
+    return flights[slot].seats.load(memory_order_acquire);
+}
+
+bool SeatInventory::tryReserve(int slot, int count) {
+    atomic<int>& seats = flights[slot].seats;
+    int cur = seats.load(memory_order_relaxed);
+    while (cur >= count) {
+        if (seats.compare_exchange_weak(cur, cur - count, memory_order_acq_rel, memory_order_relaxed)) return true;
+    }
+    return false;
+}
+
+bool SeatInventory::reserve(int slot, int count) {
+    if (count <= 0) return count == 0;
+    if (tryReserve(slot, count)) return true;
+    // Sold out as far as the counter knows; expired holds in this flight's
+    // stripe may still be sitting on seats.
+    Stripe& stripe = stripes[slot & (STRIPES - 1)];
+    if (stripe.size.load(memory_order_acquire) == 0) return false;
+    if (sweep(stripe, Clock::now()) == 0) return false;
+    return tryReserve(slot, count);
+}
+
+int SeatInventory::reserveUpTo(int slot, int count) {
+    if (count <= 0) return 0;
+    atomic<int>& seats = flights[slot].seats;
+    for (int pass = 0; pass < 2; ++pass) {
+        int cur = seats.load(memory_order_relaxed);
+        while (cur > 0) {
+            int take = min(cur, count);
+            if (seats.compare_exchange_weak(cur, cur - take, memory_order_acq_rel, memory_order_relaxed)) return take;
+        }
+        Stripe& stripe = stripes[slot & (STRIPES - 1)];
+        if (pass > 0 || stripe.size.load(memory_order_acquire) == 0) break;
+        if (sweep(stripe, Clock::now()) == 0) break;
+    }
+    return 0;
+}
+
+void SeatInventory::release(int slot, int count) {
+    if (count > 0) flights[slot].seats.fetch_add(count, memory_order_acq_rel);
+}
+
+// Holds take and give back their seats under the stripe lock, so a counter
+// read under that lock plus the stripe's holds always adds up.
+uint64_t SeatInventory::placeHold(int slot, int count, int ttlMillis) {
+    if (count <= 0) return 0;
+    int index = slot & (STRIPES - 1);
+    Stripe& stripe = stripes[index];
+    lock_guard<mutex> lock(stripe.lock);
+    if (!tryReserve(slot, count)) {
+        if (stripe.holds.empty() || sweepLocked(stripe, Clock::now()) == 0 || !tryReserve(slot, count)) return 0;
+    }
+    uint64_t id = (nextHold.fetch_add(1, memory_order_relaxed) << 6) | static_cast<uint64_t>(index);
+    stripe.holds[id] = Hold{slot, count, Clock::now() + chrono::milliseconds(ttlMillis)};
+    stripe.size.fetch_add(1, memory_order_release);
+    return id;
+}
+
+// Removes an unexpired hold and returns its seat count, giving its seats
+// back if asked; expired holds are released on the way out and report 0. A
+// live hold of other than expectedCount seats (if given) is left in place.
+int SeatInventory::takeHold(uint64_t holdId, int* slot, bool giveBack, int expectedCount) {
+    Stripe& stripe = stripes[holdId & (STRIPES - 1)];
+    lock_guard<mutex> lock(stripe.lock);
+    auto it = stripe.holds.find(holdId);
+    if (it == stripe.holds.end()) return 0;
+    Hold hold = it->second;
+    if (expectedCount >= 0 && hold.count != expectedCount && hold.expires > Clock::now()) return 0;
+    stripe.holds.erase(it);
+    stripe.size.fetch_sub(1, memory_order_release);
+    bool expired = hold.expires <= Clock::now();
+    if (giveBack || expired) release(hold.slot, hold.count);
+    if (expired) return 0;
+    if (slot) *slot = hold.slot;
+    return hold.count;
+}
+
+int SeatInventory::confirmHold(uint64_t holdId, int expectedCount, int* slot) {
+    return takeHold(holdId, slot, false, expectedCount);
+}
+
+int SeatInventory::releaseHold(uint64_t holdId) {
+    return takeHold(holdId, nullptr, true, -1);
+}
+
+int SeatInventory::sweep(Stripe& stripe, Clock::time_point now) {
+    lock_guard<mutex> lock(stripe.lock);
+    return sweepLocked(stripe, now);
+}
+
+int SeatInventory::sweepLocked(Stripe& stripe, Clock::time_point now) {
+    int freed = 0;
+    for (auto it = stripe.holds.begin(); it != stripe.holds.end();) {
+        if (it->second.expires <= now) {
+            release(it->second.slot, it->second.count);
+            freed += it->second.count;
+            it = stripe.holds.erase(it);
+            stripe.size.fetch_sub(1, memory_order_release);
+        } else {
+            ++it;
+        }
+    }
+    return freed;
+}
+
+int SeatInventory::expireHolds() {
+    Clock::time_point now = Clock::now();
+    int freed = 0;
+    for (int i = 0; i < STRIPES; ++i) {
+        if (stripes[i].size.load(memory_order_acquire) > 0) freed += sweep(stripes[i], now);
+    }
+    return freed;
+}
+
+void SeatInventory::clear() {
+    for (int i = 0; i < STRIPES; ++i) {
+        lock_guard<mutex> lock(stripes[i].lock);
+        stripes[i].holds.clear();
+        stripes[i].size.store(0, memory_order_release);
+    }
+}
+
+// A flight's holds all live in its own stripe, so locking one stripe at a
+// time is enough to read each flight's count together with its holds.
+vector<int> SeatInventory::unheldSeats() const {
+    int n = flights.size();
+    vector<int> seats(n);
+    for (int i = 0; i < STRIPES; ++i) {
+        Stripe& stripe = stripes[i];
+        lock_guard<mutex> lock(stripe.lock);
+        for (int slot = i; slot < n; slot += STRIPES) seats[slot] = available(slot);
+        for (const auto& entry : stripe.holds) seats[entry.second.slot] += entry.second.count;
+    }
+    return seats;
+}
+
+int SeatInventory::activeHolds() const {
+    int total = 0;
+    for (int i = 0; i < STRIPES; ++i) total += stripes[i].size.load(memory_order_relaxed);
+    return total;
+}
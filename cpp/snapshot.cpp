@@ -0,0 +1,399 @@
+#include "fms.h"
+#include "mapped_file.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <type_traits>
+
+using namespace std;
+
+// Snapshot layout: a fixed header holding a table of sections, then each
+// section as a packed array of fixed-size records at a 64-byte aligned
+// offset. Everything is stored in native byte order; byteOrder tells a
+// machine that differs to refuse the file. A new layout gets a new version.
+namespace {
+const char SNAPSHOT_MAGIC[8] = {'F', 'M', 'S', 'S', 'N', 'A', 'P', '\0'};
+const uint32_t SNAPSHOT_VERSION = 2;
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+const uint64_t SECTION_ALIGN = 64;
+
+enum SectionKind {
+    SECTION_FLIGHTS,          // FlightRecord by store slot
+    SECTION_FLIGHT_ORDER,     // int32 slots in flight ID order
+    SECTION_BOOKINGS,         // BookingEntry, grouped by flight in slot order
+    SECTION_NAMES,            // passenger name bytes
+    SECTION_AIRPORTS,         // AirportCode by graph index
+    SECTION_LATITUDE,         // double radians by graph index, NaN if unknown
+    SECTION_LONGITUDE,
+    SECTION_CSR_OFFSETS,      // int32, airports + 1
+    SECTION_CSR_TARGETS,      // int32 per arc
+    SECTION_CSR_WEIGHTS,      // int32 per arc
+    SECTION_ROUTE_REVERSE,    // int32 per route, see GraphImage
+    SECTION_ROUTE_COUNTS,     // int32 per route
+    SECTION_ROUTE_DISTANCES,  // int32
+    SECTION_COUNT
+};
+
+struct Section {
+    uint64_t offset;
+    uint64_t count;
+    uint32_t elementSize;
+    uint32_t reserved;
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t fileSize;
+    uint64_t logSequence;  // last write-ahead log record the snapshot holds
+    int32_t nextBookingId;
+    uint32_t sectionCount;
+    Section sections[SECTION_COUNT];
+};
+
+struct FlightRecord {
+    FlightCode flightID;
+    AirportCode source;
+    AirportCode destination;
+    int64_t departureTime;
+    int64_t arrivalTime;
+    int32_t distance;
+    int32_t seats;
+    uint32_t bookingCount;  // its live bookings, which follow the previous flight's
+    uint8_t active;
+    uint8_t padding[3];
+};
+
+struct BookingEntry {
+    int32_t bookingId;
+    uint32_t nameLength;
+    uint64_t nameOffset;  // into SECTION_NAMES
+};
+
+static_assert(is_trivially_copyable<FlightRecord>::value && sizeof(FlightRecord) == 72, "FlightRecord is on disk");
+static_assert(is_trivially_copyable<BookingEntry>::value && sizeof(BookingEntry) == 16, "BookingEntry is on disk");
+
+const uint32_t ELEMENT_SIZES[SECTION_COUNT] = {
+    sizeof(FlightRecord), sizeof(int32_t), sizeof(BookingEntry), 1, sizeof(AirportCode),
+    sizeof(double), sizeof(double), sizeof(int32_t), sizeof(int32_t), sizeof(int32_t),
+    sizeof(int32_t), sizeof(int32_t), sizeof(int32_t)};
+
+uint64_t alignUp(uint64_t offset) {
+    return (offset + SECTION_ALIGN - 1) / SECTION_ALIGN * SECTION_ALIGN;
+}
+
+template <class T>
+const T* sectionData(const MappedFile& file, const Section& section) {
+    return reinterpret_cast<const T*>(file.data() + section.offset);
+}
+
+template <class T>
+vector<T> sectionVector(const MappedFile& file, const Section& section) {
+    const T* first = sectionData<T>(file, section);
+    return vector<T>(first, first + section.count);
+}
+}
+
+void AirportGraph::saveImage(GraphImage& image) {
+    const CsrGraph& g = snapshot();
+    int n = g.nodeCount();
+    image.airports = indexToAirport;
+    image.latitude = latitude;
+    image.longitude = longitude;
+    image.csr = g;
+    image.reversePositions.clear();
+    image.distanceCounts.clear();
+    image.distances.clear();
+    image.reversePositions.reserve(routes.size());
+    image.distanceCounts.reserve(routes.size());
+    for (int u = 0; u < n; ++u) {
+        for (int e = g.begin(u); e < g.end(u); ++e) {
+            int v = g.targets[e];
+            if (v < u) continue;
+            const Route& r = routes.find(routeKey(u, v))->second;
+            image.reversePositions.push_back(r.u == u ? r.posV : r.posU);
+            image.distanceCounts.push_back(static_cast<int>(r.distances.size()));
+            image.distances.insert(image.distances.end(), r.distances.begin(), r.distances.end());
+        }
+    }
+}
+
+bool AirportGraph::loadImage(GraphImage&& image) {
+    const CsrGraph& g = image.csr;
+    int n = static_cast<int>(image.airports.size());
+    if (image.latitude.size() != static_cast<size_t>(n) || image.longitude.size() != static_cast<size_t>(n)) return false;
+    if (g.offsets.size() != static_cast<size_t>(n) + 1 || g.offsets[0] != 0) return false;
+    if (g.targets.size() != g.weights.size() || static_cast<size_t>(g.offsets[n]) != g.targets.size()) return false;
+    size_t route = 0, distance = 0;
+    for (int u = 0; u < n; ++u) {
+        if (g.offsets[u + 1] < g.offsets[u]) return false;
+        for (int e = g.begin(u); e < g.end(u); ++e) {
+            int v = g.targets[e];
+            if (v < 0 || v >= n || v == u || g.weights[e] < 0) return false;
+            if (v < u) continue;
+            if (route >= image.reversePositions.size() || route >= image.distanceCounts.size()) return false;
+            int back = image.reversePositions[route], count = image.distanceCounts[route];
+            if (back < 0 || back >= g.end(v) - g.begin(v) || g.targets[g.begin(v) + back] != u) return false;
+            if (count <= 0 || image.distances.size() - distance < static_cast<size_t>(count)) return false;
+            route++;
+            distance += count;
+        }
+    }
+    if (route != image.reversePositions.size() || route != image.distanceCounts.size()
+        || distance != image.distances.size()) return false;
+    for (int d : image.distances) {
+        if (d < 0) return false;
+    }
+    unordered_map<AirportCode, int> index;
+    index.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        if (!index.emplace(image.airports[i], i).second) return false;
+    }
+
+    airportIndex = std::move(index);
+    indexToAirport = std::move(image.airports);
+    adj.assign(n, {});
+    routes.clear();
+    routes.reserve(route);
+    route = 0;
+    distance = 0;
+    for (int u = 0; u < n; ++u) {
+        adj[u].reserve(g.end(u) - g.begin(u));
+        for (int e = g.begin(u); e < g.end(u); ++e) {
+            int v = g.targets[e];
+            adj[u].push_back({v, g.weights[e]});
+            if (v < u) continue;
+            auto first = image.distances.begin() + distance;
+            int count = image.distanceCounts[route];
+            routes.emplace(routeKey(u, v), Route{u, v, e - g.begin(u), image.reversePositions[route],
+                                                 vector<int>(first, first + count)});
+            route++;
+            distance += count;
+        }
+    }
+    csr = std::move(image.csr);
+    csrDirty = false;
+    latitude = std::move(image.latitude);
+    longitude = std::move(image.longitude);
+    coordinateCount = static_cast<int>(count_if(latitude.begin(), latitude.end(), [](double x) { return !std::isnan(x); }));
+    heuristicScale = 0;
+    heuristicDirty = true;
+    graphVersion++;
+    matrixValid = false;
+    matrixChanges.clear();
+    // Sized now so addEdge can keep uniting until the next refresh.
+    connectivity.init(n);
+    componentTotal = n;
+    connectivityStale = true;
+    return true;
+}
+
+bool FlightSystem::saveSnapshot(const std::string& path) {
+    LogPosition position;
+    return writeSnapshot(path, position);
+}
+
+// Seats are saved with every hold's seats given back, since holds are not.
+bool FlightSystem::writeSnapshot(const std::string& path, LogPosition& position) {
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    vector<FlightRecord> records;
+    vector<BookingEntry> entries;
+    string names;
+    GraphImage image;
+    {
+        lock_guard<mutex> lock(bookingMutex);
+        int n = flights.size();
+        vector<int> seats = seatInventory.unheldSeats();
+        records.resize(n);
+        for (int i = 0; i < n; ++i) {
+            const Flight& f = flights[i];
+            FlightRecord& r = records[i];
+            r.flightID = f.flightID;
+            r.source = f.source;
+            r.destination = f.destination;
+            r.departureTime = f.departureTime;
+            r.arrivalTime = f.arrivalTime;
+            r.distance = f.distance;
+            r.seats = seats[i];
+            r.active = f.active;
+            size_t before = entries.size();
+            bookings.forEach(i, [&](const BookingRecord& b) {
+                entries.push_back({b.bookingId, static_cast<uint32_t>(b.passengerName.size()), names.size()});
+                names += b.passengerName;
+            });
+            r.bookingCount = static_cast<uint32_t>(entries.size() - before);
+        }
+        header.nextBookingId = bookings.nextBookingId();
+        position = wal.position();
+        header.logSequence = position.sequence;
+        lock_guard<shared_mutex> graphLock(graphMutex);
+        graph.saveImage(image);
+    }
+    vector<int32_t> order(records.size());
+    iota(order.begin(), order.end(), 0);
+    parallelSort(order.begin(), order.end(),
+                 [&](int32_t a, int32_t b) { return records[a].flightID < records[b].flightID; });
+
+    const void* data[SECTION_COUNT] = {
+        records.data(), order.data(), entries.data(), names.data(), image.airports.data(),
+        image.latitude.data(), image.longitude.data(), image.csr.offsets.data(), image.csr.targets.data(),
+        image.csr.weights.data(), image.reversePositions.data(), image.distanceCounts.data(), image.distances.data()};
+    const size_t counts[SECTION_COUNT] = {
+        records.size(), order.size(), entries.size(), names.size(), image.airports.size(),
+        image.latitude.size(), image.longitude.size(), image.csr.offsets.size(), image.csr.targets.size(),
+        image.csr.weights.size(), image.reversePositions.size(), image.distanceCounts.size(), image.distances.size()};
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.sectionCount = SECTION_COUNT;
+    uint64_t offset = alignUp(sizeof(header));
+    for (int k = 0; k < SECTION_COUNT; ++k) {
+        header.sections[k] = {offset, counts[k], ELEMENT_SIZES[k], 0};
+        offset = alignUp(offset + counts[k] * ELEMENT_SIZES[k]);
+    }
+    header.fileSize = offset;
+
+    string temp = path + ".tmp";
+    int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    bool ok = writeAt(fd, &header, sizeof(header), 0);
+    for (int k = 0; ok && k < SECTION_COUNT; ++k) {
+        ok = writeAt(fd, data[k], counts[k] * ELEMENT_SIZES[k], header.sections[k].offset);
+    }
+    ok = ok && ::ftruncate(fd, static_cast<off_t>(header.fileSize)) == 0 && ::fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    if (!ok || ::rename(temp.c_str(), path.c_str()) != 0) {
+        ::unlink(temp.c_str());
+        return false;
+    }
+    syncDirectory(path);
+    return true;
+}
+
+// Everything that can be checked or built without the locks is: the file is
+// validated and each flight's booking records are assembled in parallel
+// first, and the live structures are only replaced once the graph image has
+// been accepted.
+bool FlightSystem::loadSnapshot(const std::string& path) {
+    if (wal.isOpen()) return false;
+    MappedFile file(path);
+    if (!file.isOpen() || file.size() < sizeof(SnapshotHeader)) return false;
+    SnapshotHeader header;
+    memcpy(&header, file.data(), sizeof(header));
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 || header.version != SNAPSHOT_VERSION
+        || header.byteOrder != BYTE_ORDER_MARK || header.fileSize != file.size()
+        || header.sectionCount != SECTION_COUNT || header.nextBookingId < 1) return false;
+    for (int k = 0; k < SECTION_COUNT; ++k) {
+        const Section& s = header.sections[k];
+        if (s.elementSize != ELEMENT_SIZES[k] || s.offset % SECTION_ALIGN != 0 || s.offset > file.size()
+            || s.count > (file.size() - s.offset) / s.elementSize) return false;
+    }
+    const Section* sections = header.sections;
+    if (sections[SECTION_FLIGHTS].count > INT_MAX
+        || sections[SECTION_FLIGHT_ORDER].count != sections[SECTION_FLIGHTS].count) return false;
+    int n = static_cast<int>(sections[SECTION_FLIGHTS].count);
+    const FlightRecord* records = sectionData<FlightRecord>(file, sections[SECTION_FLIGHTS]);
+    const int32_t* order = sectionData<int32_t>(file, sections[SECTION_FLIGHT_ORDER]);
+    const BookingEntry* entries = sectionData<BookingEntry>(file, sections[SECTION_BOOKINGS]);
+    const char* names = file.data() + sections[SECTION_NAMES].offset;
+    uint64_t nameBytes = sections[SECTION_NAMES].count;
+
+    vector<uint64_t> firstBooking(n + 1, 0);
+    for (int i = 0; i < n; ++i) {
+        if (order[i] < 0 || order[i] >= n || records[i].distance < 0 || records[i].seats < 0) return false;
+        firstBooking[i + 1] = firstBooking[i] + records[i].bookingCount;
+    }
+    if (firstBooking[n] != sections[SECTION_BOOKINGS].count) return false;
+    // A booking ID may appear once across all flights.
+    vector<char> seenBooking(header.nextBookingId, 0);
+    for (uint64_t b = 0; b < firstBooking[n]; ++b) {
+        int32_t id = entries[b].bookingId;
+        if (id <= 0 || id >= header.nextBookingId || seenBooking[id]) return false;
+        seenBooking[id] = 1;
+    }
+    // Strictly increasing IDs make order a permutation and every ID unique
+    // (and non-empty, the empty code sorting first).
+    for (int i = 0; i < n; ++i) {
+        FlightCode id = records[order[i]].flightID;
+        if (i == 0 ? id.empty() : !(records[order[i - 1]].flightID < id)) return false;
+    }
+    vector<vector<BookingRecord>> flightBookings(n);
+    atomic<bool> corrupt(false);
+    parallelFor(0, n, [&](int i) {
+        vector<BookingRecord>& out = flightBookings[i];
+        out.reserve(records[i].bookingCount);
+        for (uint64_t b = firstBooking[i]; b < firstBooking[i + 1]; ++b) {
+            const BookingEntry& e = entries[b];
+            if (e.nameOffset > nameBytes || e.nameLength > nameBytes - e.nameOffset) {
+                corrupt.store(true, memory_order_relaxed);
+                return;
+            }
+            out.push_back({e.bookingId, string(names + e.nameOffset, e.nameLength)});
+        }
+    }, 0, 256);
+    if (corrupt.load()) return false;
+
+    GraphImage image;
+    image.airports = sectionVector<AirportCode>(file, sections[SECTION_AIRPORTS]);
+    image.latitude = sectionVector<double>(file, sections[SECTION_LATITUDE]);
+    image.longitude = sectionVector<double>(file, sections[SECTION_LONGITUDE]);
+    image.csr.offsets = sectionVector<int>(file, sections[SECTION_CSR_OFFSETS]);
+    image.csr.targets = sectionVector<int>(file, sections[SECTION_CSR_TARGETS]);
+    image.csr.weights = sectionVector<int>(file, sections[SECTION_CSR_WEIGHTS]);
+    image.reversePositions = sectionVector<int>(file, sections[SECTION_ROUTE_REVERSE]);
+    image.distanceCounts = sectionVector<int>(file, sections[SECTION_ROUTE_COUNTS]);
+    image.distances = sectionVector<int>(file, sections[SECTION_ROUTE_DISTANCES]);
+
+    // Queued requests name flights by slot, so they are settled against the
+    // old flights (stopping the worker drains the queue) or dropped.
+    bool restartWorker = workerRunning.load();
+    stopBookingWorker();
+    bool loaded;
+    {
+        lock_guard<mutex> consumer(queueConsumerMutex);
+        lock_guard<mutex> lock(bookingMutex);
+        {
+            lock_guard<shared_mutex> graphLock(graphMutex);
+            loaded = graph.loadImage(std::move(image));
+        }
+        if (loaded) {
+            BookingRequest stale;
+            while (bookingQueue.pop(stale)) {}
+            lock_guard<shared_mutex> timetableLock(timetableMutex);
+            lock_guard<shared_mutex> idLock(flightIdMutex);
+            seatInventory.clear();
+            flightIndex.clear();
+            flightIds.clear();
+            flights.clear();
+            for (int i = 0; i < n; ++i) {
+                const FlightRecord& r = records[i];
+                Flight& f = flights.append();
+                f.flightID = r.flightID;
+                f.source = r.source;
+                f.destination = r.destination;
+                f.distance = r.distance;
+                f.seats.store(r.seats);
+                f.active = r.active != 0;
+                f.departureTime = r.departureTime;
+                f.arrivalTime = r.arrivalTime;
+            }
+            flightIds.insertRange(0, n);
+            vector<Flight*> byId(n);
+            for (int i = 0; i < n; ++i) byId[i] = &flights[order[i]];
+            flightIndex.bulkBuild(std::move(byId));
+            searchIndex.build(flights);
+            bookings.reset(n, header.nextBookingId);
+            parallelFor(0, n, [&](int i) { bookings.restore(i, std::move(flightBookings[i])); }, 0, 256);
+            timetableDirty = true;
+            wal.setSequence(header.logSequence);
+            lock_guard<mutex> searchLock(searchMutex);
+            for (AirportCode source : recentSearches.recent()) recentSearches.invalidate(source);
+        }
+    }
+    if (restartWorker) startBookingWorker();
+    return loaded;
+}
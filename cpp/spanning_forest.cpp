@@ -0,0 +1,230 @@
+#include "fms.h"
+#include "parallel_for.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <numeric>
+#include <queue>
+
+using namespace std;
+
+namespace {
+struct RouteEdge {
+    int u, v;  // u < v
+    int w;
+};
+
+// Distance, then airport indices: a strict total order over routes, so there
+// is exactly one minimum spanning forest under it.
+bool lighter(const RouteEdge& a, const RouteEdge& b) {
+    if (a.w != b.w) return a.w < b.w;
+    return a.u != b.u ? a.u < b.u : a.v < b.v;
+}
+
+// Every route once, ordered by (u, v), so position in the list breaks ties
+// the same way lighter() does. Airports are filled in parallel, each from
+// its own offset.
+vector<RouteEdge> routeList(const CsrGraph& g, int threads) {
+    int n = g.nodeCount();
+    vector<int> offset(n + 1, 0);
+    parallelFor(0, n, [&](int u) {
+        int count = 0;
+        for (int e = g.begin(u); e < g.end(u); ++e) count += g.targets[e] > u;
+        offset[u + 1] = count;
+    }, threads, 1024);
+    partial_sum(offset.begin(), offset.end(), offset.begin());
+    vector<RouteEdge> edges(offset[n]);
+    parallelFor(0, n, [&](int u) {
+        RouteEdge* out = edges.data() + offset[u];
+        for (int e = g.begin(u); e < g.end(u); ++e) {
+            if (g.targets[e] > u) *out++ = {u, g.targets[e], g.weights[e]};
+        }
+        sort(edges.begin() + offset[u], edges.begin() + offset[u + 1],
+             [](const RouteEdge& a, const RouteEdge& b) { return a.v < b.v; });
+    }, threads, 1024);
+    return edges;
+}
+
+// Union-find that any number of threads may use at once. find halves the
+// path with compare-and-swap as it walks, and unite always hangs the root
+// with the larger index under the other, so indices only decrease along a
+// path and racing unions can never close a cycle. Neither one recurses.
+class ConcurrentUnionFind {
+public:
+    ConcurrentUnionFind(int n, int threads) : parent(n) {
+        parallelFor(0, n, [&](int i) { parent[i].store(i, memory_order_relaxed); }, threads, 4096);
+    }
+
+    int find(int x) {
+        for (;;) {
+            int p = parent[x].load(memory_order_relaxed);
+            if (p == x) return x;
+            int grandparent = parent[p].load(memory_order_relaxed);
+            if (grandparent != p) parent[x].compare_exchange_weak(p, grandparent, memory_order_relaxed);
+            x = grandparent;
+        }
+    }
+
+    // False if a and b were already in the same set.
+    bool unite(int a, int b) {
+        for (;;) {
+            a = find(a);
+            b = find(b);
+            if (a == b) return false;
+            if (a < b) swap(a, b);
+            int expected = a;
+            if (parent[a].compare_exchange_strong(expected, b, memory_order_relaxed)) return true;
+        }
+    }
+
+private:
+    vector<atomic<int>> parent;
+};
+
+// Keys for a component's cheapest route out: distance (sign bit flipped so
+// that unsigned order matches signed order) above the route's position in
+// the list.
+const uint64_t NO_ROUTE = UINT64_MAX;
+
+uint64_t pickKey(const RouteEdge& e, int id) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(e.w) ^ 0x80000000u) << 32) | static_cast<uint32_t>(id);
+}
+
+void lowerTo(atomic<uint64_t>& slot, uint64_t key) {
+    uint64_t current = slot.load(memory_order_relaxed);
+    while (key < current && !slot.compare_exchange_weak(current, key, memory_order_relaxed)) {}
+}
+}
+
+SpanningForest AirportGraph::primTree(AirportCode start) {
+    SpanningForest tree{0, {}};
+    auto it = airportIndex.find(start);
+    if (it == airportIndex.end()) return tree;
+    const CsrGraph& g = snapshot();
+    int n = g.nodeCount();
+    vector<int> key(n, INT_MAX);
+    vector<int> parent(n, -1);
+    vector<bool> inMST(n, false);
+    using PII = pair<int,int>;
+    priority_queue<PII, vector<PII>, greater<PII>> pq;
+
+    int s = it->second;
+    key[s] = 0;
+    pq.push({0, s});
+
+    while (!pq.empty()) {
+        int u = pq.top().second; pq.pop();
+        if (inMST[u]) continue;
+        inMST[u] = true;
+        for (int e = g.begin(u); e < g.end(u); ++e) {
+            int v = g.targets[e], w = g.weights[e];
+            if (!inMST[v] && w < key[v]) {
+                key[v] = w;
+                parent[v] = u;
+                pq.push({key[v], v});
+            }
+        }
+    }
+
+    for (int v = 0; v < n; ++v) {
+        if (parent[v] != -1) {
+            tree.edges.push_back({indexToAirport[parent[v]], indexToAirport[v], key[v]});
+            tree.weight += key[v];
+        }
+    }
+    return tree;
+}
+
+SpanningForest AirportGraph::kruskalForest(int threads) {
+    const CsrGraph& g = snapshot();
+    int n = g.nodeCount();
+    vector<RouteEdge> edges = routeList(g, threads);
+    parallelSort(edges.begin(), edges.end(), lighter, threads);
+
+    DSU dsu(n);
+    SpanningForest forest{0, {}};
+    for (const RouteEdge& e : edges) {
+        if (!dsu.unite(e.u, e.v)) continue;
+        forest.edges.push_back({indexToAirport[e.u], indexToAirport[e.v], e.w});
+        forest.weight += e.w;
+        if (static_cast<int>(forest.edges.size()) == n - 1) break;
+    }
+    return forest;
+}
+
+// Each round, every component still joined to another by some route finds its
+// cheapest route out (an atomic minimum per component over all live routes)
+// and is merged along it. Under a strict order those picks never close a
+// cycle; two components picking the same route is caught by unite. Every
+// round at least halves the components that still have a route out, and
+// routes inside a component are dropped as they are found.
+SpanningForest AirportGraph::boruvkaForest(int threads) {
+    const CsrGraph& g = snapshot();
+    int n = g.nodeCount();
+    vector<RouteEdge> edges = routeList(g, threads);
+    int m = static_cast<int>(edges.size());
+    ConcurrentUnionFind sets(n, threads);
+    vector<atomic<uint64_t>> cheapest(n);
+
+    // Ids of the routes still between two components, compacted in place
+    // within fixed blocks so that blocks can be filtered independently.
+    const int BLOCK = 4096;
+    int blocks = (m + BLOCK - 1) / BLOCK;
+    vector<int> live(m);
+    iota(live.begin(), live.end(), 0);
+    vector<int> liveCount(blocks);
+    for (int b = 0; b < blocks; ++b) liveCount[b] = min(BLOCK, m - b * BLOCK);
+
+    vector<int> components(n);
+    iota(components.begin(), components.end(), 0);
+    vector<int> merged;
+    vector<int> picked;
+    while (!components.empty()) {
+        int count = static_cast<int>(components.size());
+        parallelFor(0, count, [&](int i) { cheapest[components[i]].store(NO_ROUTE, memory_order_relaxed); },
+                    threads, 4096);
+        parallelFor(0, blocks, [&](int b) {
+            int* ids = live.data() + static_cast<size_t>(b) * BLOCK;
+            int kept = 0;
+            for (int i = 0; i < liveCount[b]; ++i) {
+                const RouteEdge& e = edges[ids[i]];
+                int cu = sets.find(e.u), cv = sets.find(e.v);
+                if (cu == cv) continue;
+                uint64_t key = pickKey(e, ids[i]);
+                lowerTo(cheapest[cu], key);
+                lowerTo(cheapest[cv], key);
+                ids[kept++] = ids[i];
+            }
+            liveCount[b] = kept;
+        }, threads);
+
+        merged.assign(count, -1);
+        parallelFor(0, count, [&](int i) {
+            uint64_t key = cheapest[components[i]].load(memory_order_relaxed);
+            if (key == NO_ROUTE) return;
+            int id = static_cast<int>(key & 0xffffffffu);
+            if (sets.unite(edges[id].u, edges[id].v)) merged[i] = id;
+        }, threads, 256);
+
+        // A component with no route out is finished; one that merged lives
+        // on as its new root, which is itself in the list.
+        int remaining = 0;
+        for (int i = 0; i < count; ++i) {
+            int c = components[i];
+            if (cheapest[c].load(memory_order_relaxed) == NO_ROUTE) continue;
+            if (merged[i] != -1) picked.push_back(merged[i]);
+            if (sets.find(c) == c) components[remaining++] = c;
+        }
+        components.resize(remaining);
+    }
+
+    parallelSort(picked.begin(), picked.end(), [&](int a, int b) { return lighter(edges[a], edges[b]); }, threads);
+    SpanningForest forest{0, {}};
+    forest.edges.reserve(picked.size());
+    for (int id : picked) {
+        const RouteEdge& e = edges[id];
+        forest.edges.push_back({indexToAirport[e.u], indexToAirport[e.v], e.w});
+        forest.weight += e.w;
+    }
+    return forest;
+}
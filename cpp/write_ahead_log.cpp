@@ -0,0 +1,425 @@
+#include "fms.h"
+#include "mapped_file.h"
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+using namespace std;
+
+// Log layout: a file header, then one record after another, each an
+// EntryHeader followed by tailSize bytes (a FlightTail for LOG_ADD_FLIGHT,
+// the passenger name for LOG_BOOK). Sequence numbers go up by one from
+// record to record. A record whose tail runs past the end of the file or
+// whose checksum does not match is where a crash interrupted a write, and
+// it ends the log. Native byte order, as in snapshots.
+namespace {
+const char LOG_MAGIC[8] = {'F', 'M', 'S', 'L', 'O', 'G', '\0', '\0'};
+const uint32_t LOG_VERSION = 1;
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+const size_t COPY_CHUNK = 1 << 20;
+
+struct LogFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+};
+
+// The checksum covers the bytes after it up to sequence, then the tail,
+// then sequence, so everything but the sequence number can be hashed
+// before the log's lock is taken.
+struct EntryHeader {
+    uint32_t checksum;  // FNV-1a
+    uint32_t tailSize;
+    FlightCode flightID;
+    int32_t bookingId;
+    uint8_t type;
+    uint8_t padding[3];
+    uint64_t sequence;
+};
+
+struct FlightTail {
+    AirportCode source;
+    AirportCode destination;
+    int64_t departureTime;
+    int64_t arrivalTime;
+    int32_t distance;
+    int32_t seats;
+};
+
+static_assert(is_trivially_copyable<EntryHeader>::value && sizeof(EntryHeader) == 32, "EntryHeader is on disk");
+static_assert(is_trivially_copyable<FlightTail>::value && sizeof(FlightTail) == 56, "FlightTail is on disk");
+
+const uint32_t FNV_BASIS = 2166136261u;
+
+uint32_t fnv1a(uint32_t hash, const void* data, size_t bytes) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < bytes; ++i) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+uint32_t partialChecksum(const EntryHeader& entry, const void* tail) {
+    const char* fields = reinterpret_cast<const char*>(&entry);
+    uint32_t hash = fnv1a(FNV_BASIS, fields + sizeof(entry.checksum),
+                          offsetof(EntryHeader, sequence) - sizeof(entry.checksum));
+    return fnv1a(hash, tail, entry.tailSize);
+}
+
+uint32_t finishChecksum(uint32_t hash, uint64_t sequence) {
+    return fnv1a(hash, &sequence, sizeof(sequence));
+}
+
+bool decode(const EntryHeader& entry, const char* tail, LogRecord& record) {
+    record.type = static_cast<LogRecordType>(entry.type);
+    record.sequence = entry.sequence;
+    record.flightID = entry.flightID;
+    switch (entry.type) {
+    case LOG_ADD_FLIGHT: {
+        if (entry.tailSize != sizeof(FlightTail)) return false;
+        FlightTail flight;
+        memcpy(&flight, tail, sizeof(flight));
+        record.source = flight.source;
+        record.destination = flight.destination;
+        record.departureTime = flight.departureTime;
+        record.arrivalTime = flight.arrivalTime;
+        record.distance = flight.distance;
+        record.seats = flight.seats;
+        return true;
+    }
+    case LOG_BOOK:
+        record.bookingId = entry.bookingId;
+        record.passengerName.assign(tail, entry.tailSize);
+        return true;
+    case LOG_CANCEL_BOOKING:
+        record.bookingId = entry.bookingId;
+        return entry.tailSize == 0;
+    case LOG_CANCEL_FLIGHT:
+    case LOG_SCHEDULE_FLIGHT:
+        return entry.tailSize == 0;
+    }
+    return false;
+}
+}
+
+WriteAheadLog::WriteAheadLog()
+    : path(), fd(-1), durability(LOG_SYNCED), groupCommitWindow(0), lock(), flushDone(), buffer(), writing(),
+      appended(0), written(0), synced(0), fileSize(0), endOffset(0), flushing(false), broken(false), counters() {}
+
+WriteAheadLog::~WriteAheadLog() {
+    close();
+}
+
+// Replay runs without the lock: nothing is appended while the log is
+// closed, and the caller keeps other opens and closes away.
+long long WriteAheadLog::open(const std::string& logPath, LogDurability level, int groupCommitMicros,
+                              const std::function<bool(const LogRecord&)>& replay) {
+    if (isOpen()) return -1;
+    int file = ::open(logPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (file < 0) return -1;
+    uint64_t base = lastSequence(), last = base, previous = 0;
+    uint64_t end = sizeof(LogFileHeader), size = 0;
+    long long replayed = 0;
+    bool ok, fresh;
+    {
+        MappedFile map(logPath);
+        ok = map.isOpen();
+        size = map.size();
+        // Shorter than a header: new, or cut short while it was being created.
+        fresh = size < sizeof(LogFileHeader);
+        if (ok && !fresh) {
+            LogFileHeader header;
+            memcpy(&header, map.data(), sizeof(header));
+            ok = memcmp(header.magic, LOG_MAGIC, sizeof(header.magic)) == 0 && header.version == LOG_VERSION
+                 && header.byteOrder == BYTE_ORDER_MARK;
+        }
+        while (ok && !fresh && size - end >= sizeof(EntryHeader)) {
+            EntryHeader entry;
+            memcpy(&entry, map.data() + end, sizeof(entry));
+            const char* tail = map.data() + end + sizeof(entry);
+            if (entry.tailSize > size - end - sizeof(entry)
+                || finishChecksum(partialChecksum(entry, tail), entry.sequence) != entry.checksum) break;
+            if (previous != 0 ? entry.sequence != previous + 1 : entry.sequence > base + 1) {
+                ok = false;
+                break;
+            }
+            if (entry.sequence > base) {
+                LogRecord record;
+                if (!decode(entry, tail, record) || !replay(record)) {
+                    ok = false;
+                    break;
+                }
+                last = entry.sequence;
+                replayed++;
+            }
+            previous = entry.sequence;
+            end += sizeof(entry) + entry.tailSize;
+        }
+    }
+    setSequence(last);
+    if (ok && fresh) {
+        LogFileHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, LOG_MAGIC, sizeof(header.magic));
+        header.version = LOG_VERSION;
+        header.byteOrder = BYTE_ORDER_MARK;
+        ok = writeAt(file, &header, sizeof(header), 0) && ::ftruncate(file, sizeof(header)) == 0;
+    } else if (ok && size > end) {
+        ok = ::ftruncate(file, static_cast<off_t>(end)) == 0;
+    }
+    ok = ok && ::fdatasync(file) == 0;
+    if (!ok) {
+        ::close(file);
+        return -1;
+    }
+    if (fresh) syncDirectory(logPath);
+
+    lock_guard<mutex> guard(lock);
+    path = logPath;
+    fd = file;
+    durability = level;
+    groupCommitWindow = chrono::microseconds(max(0, groupCommitMicros));
+    buffer.clear();
+    fileSize = endOffset = end;
+    flushing = false;
+    broken = false;
+    counters = LogStats();
+    return replayed;
+}
+
+bool WriteAheadLog::close() {
+    unique_lock<mutex> guard(lock);
+    if (fd < 0) return true;
+    bool ok = flushLocked(guard, appended, true) && writeBufferLocked() && ::fdatasync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    fd = -1;
+    buffer.clear();
+    return ok;
+}
+
+bool WriteAheadLog::isOpen() const {
+    lock_guard<mutex> guard(lock);
+    return fd >= 0;
+}
+
+uint64_t WriteAheadLog::append(LogRecordType type, FlightCode flightID, int bookingId, const void* tail,
+                               uint32_t tailSize) {
+    EntryHeader entry{};
+    entry.tailSize = tailSize;
+    entry.flightID = flightID;
+    entry.bookingId = bookingId;
+    entry.type = static_cast<uint8_t>(type);
+    uint32_t hash = partialChecksum(entry, tail);
+    lock_guard<mutex> guard(lock);
+    if (fd < 0 || broken) return 0;
+    entry.sequence = ++appended;
+    entry.checksum = finishChecksum(hash, entry.sequence);
+    const char* head = reinterpret_cast<const char*>(&entry);
+    buffer.insert(buffer.end(), head, head + sizeof(entry));
+    buffer.insert(buffer.end(), static_cast<const char*>(tail), static_cast<const char*>(tail) + tailSize);
+    endOffset += sizeof(entry) + tailSize;
+    counters.records++;
+    counters.bytes += sizeof(entry) + tailSize;
+    return entry.sequence;
+}
+
+uint64_t WriteAheadLog::appendFlight(const Flight& f) {
+    FlightTail tail = {f.source, f.destination, f.departureTime, f.arrivalTime, f.distance, f.seats.load()};
+    return append(LOG_ADD_FLIGHT, f.flightID, 0, &tail, sizeof(tail));
+}
+
+uint64_t WriteAheadLog::appendFlightState(FlightCode flightID, bool active) {
+    return append(active ? LOG_SCHEDULE_FLIGHT : LOG_CANCEL_FLIGHT, flightID, 0, nullptr, 0);
+}
+
+uint64_t WriteAheadLog::appendBooking(FlightCode flightID, int bookingId, const std::string& passengerName) {
+    return append(LOG_BOOK, flightID, bookingId, passengerName.data(), static_cast<uint32_t>(passengerName.size()));
+}
+
+uint64_t WriteAheadLog::appendCancellation(FlightCode flightID, int bookingId) {
+    return append(LOG_CANCEL_BOOKING, flightID, bookingId, nullptr, 0);
+}
+
+bool WriteAheadLog::commit(uint64_t sequence) {
+    unique_lock<mutex> guard(lock);
+    if (fd < 0 || sequence == 0) return !broken;
+    if (durability == LOG_BUFFERED) {
+        return buffer.size() < BUFFER_LIMIT ? !broken : flushLocked(guard, appended, false);
+    }
+    return flushLocked(guard, sequence, durability == LOG_SYNCED);
+}
+
+bool WriteAheadLog::flush() {
+    unique_lock<mutex> guard(lock);
+    if (fd < 0) return !broken;
+    return flushLocked(guard, appended, true);
+}
+
+// Until sequence is written (and synced if asked), either wait for the
+// committer doing I/O or become it: take the whole buffer, write it and sync
+// without the lock, then wake everyone it covered.
+bool WriteAheadLog::flushLocked(std::unique_lock<std::mutex>& guard, uint64_t sequence, bool sync) {
+    for (;;) {
+        if (broken) return false;
+        if ((sync ? synced : written) >= sequence) return true;
+        if (flushing) {
+            flushDone.wait(guard);
+            continue;
+        }
+        flushing = true;
+        if (sync && groupCommitWindow.count() > 0) {
+            guard.unlock();
+            this_thread::sleep_for(groupCommitWindow);
+            guard.lock();
+        }
+        writing.swap(buffer);
+        uint64_t through = appended, offset = fileSize;
+        guard.unlock();
+        bool ok = writing.empty() || writeAt(fd, writing.data(), writing.size(), offset);
+        ok = ok && (!sync || ::fdatasync(fd) == 0);
+        guard.lock();
+        counters.writes += !writing.empty();
+        counters.syncs += sync;
+        fileSize += writing.size();
+        writing.clear();
+        if (ok) {
+            written = through;
+            if (sync) synced = through;
+        }
+        broken = broken || !ok;
+        flushing = false;
+        flushDone.notify_all();
+    }
+}
+
+// Lock held and no flush running: writes what was appended meanwhile.
+bool WriteAheadLog::writeBufferLocked() {
+    if (broken) return false;
+    if (buffer.empty()) return true;
+    if (!writeAt(fd, buffer.data(), buffer.size(), fileSize)) {
+        broken = true;
+        return false;
+    }
+    counters.writes++;
+    fileSize += buffer.size();
+    buffer.clear();
+    written = appended;
+    return true;
+}
+
+// Appends wait on the lock for as long as the copy takes, which is short as
+// long as position was taken recently.
+bool WriteAheadLog::discardThrough(LogPosition position) {
+    unique_lock<mutex> guard(lock);
+    if (fd < 0) return true;
+    if (!flushLocked(guard, appended, true) || !writeBufferLocked()) return false;
+    if (position.offset < sizeof(LogFileHeader) || position.offset > fileSize) return false;
+
+    string temp = path + ".tmp";
+    int out = ::open(temp.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (out < 0) return false;
+    vector<char> chunk(COPY_CHUNK);
+    bool ok = ::pread(fd, chunk.data(), sizeof(LogFileHeader), 0) == static_cast<ssize_t>(sizeof(LogFileHeader))
+              && writeAt(out, chunk.data(), sizeof(LogFileHeader), 0);
+    uint64_t to = sizeof(LogFileHeader);
+    for (uint64_t from = position.offset; ok && from < fileSize;) {
+        size_t bytes = static_cast<size_t>(min<uint64_t>(COPY_CHUNK, fileSize - from));
+        ssize_t got = ::pread(fd, chunk.data(), bytes, static_cast<off_t>(from));
+        if (got < 0 && errno == EINTR) continue;
+        ok = got > 0 && writeAt(out, chunk.data(), static_cast<size_t>(got), to);
+        from += static_cast<uint64_t>(max<ssize_t>(got, 0));
+        to += static_cast<uint64_t>(max<ssize_t>(got, 0));
+    }
+    ok = ok && ::fdatasync(out) == 0 && ::rename(temp.c_str(), path.c_str()) == 0;
+    if (!ok) {
+        ::close(out);
+        ::unlink(temp.c_str());
+        return false;
+    }
+    syncDirectory(path);
+    ::close(fd);
+    fd = out;
+    fileSize = endOffset = to;
+    synced = written = appended;
+    return true;
+}
+
+uint64_t WriteAheadLog::lastSequence() const {
+    lock_guard<mutex> guard(lock);
+    return appended;
+}
+
+void WriteAheadLog::setSequence(uint64_t sequence) {
+    lock_guard<mutex> guard(lock);
+    appended = written = synced = sequence;
+}
+
+LogPosition WriteAheadLog::position() const {
+    lock_guard<mutex> guard(lock);
+    return {appended, endOffset};
+}
+
+LogStats WriteAheadLog::stats() const {
+    lock_guard<mutex> guard(lock);
+    return counters;
+}
+
+bool WriteAheadLog::failed() const {
+    lock_guard<mutex> guard(lock);
+    return broken;
+}
+
+// Replay holds bookingMutex throughout, taken before the log's lock as when
+// a mutation is logged.
+long long FlightSystem::openLog(const std::string& path, LogDurability durability, int groupCommitMicros) {
+    lock_guard<mutex> lock(bookingMutex);
+    return wal.open(path, durability, groupCommitMicros, [this](const LogRecord& r) { return applyLogRecord(r); });
+}
+
+bool FlightSystem::closeLog() {
+    return wal.close();
+}
+
+bool FlightSystem::flushLog() {
+    return wal.flush();
+}
+
+bool FlightSystem::checkpoint(const std::string& snapshotPath) {
+    LogPosition position;
+    return writeSnapshot(snapshotPath, position) && wal.discardThrough(position);
+}
+
+LogStats FlightSystem::logStats() const {
+    return wal.stats();
+}
+
+bool FlightSystem::logHealthy() const {
+    return !wal.failed();
+}
+
+// Caller holds bookingMutex and the log is closed, so nothing is logged
+// again. A booking must get the ID it was logged with, which holds as long
+// as replay starts from the state the log was written against.
+bool FlightSystem::applyLogRecord(const LogRecord& record) {
+    if (record.type == LOG_ADD_FLIGHT) {
+        return insertFlight(record.flightID, record.source, record.destination, record.distance, record.seats,
+                            record.departureTime, record.arrivalTime);
+    }
+    int index = flightIds.find(record.flightID);
+    if (index < 0) return false;
+    switch (record.type) {
+    case LOG_CANCEL_FLIGHT:
+    case LOG_SCHEDULE_FLIGHT:
+        setFlightActive(index, record.type == LOG_SCHEDULE_FLIGHT);
+        return true;
+    case LOG_BOOK:
+        return confirmBooking(index, record.passengerName) == record.bookingId;
+    case LOG_CANCEL_BOOKING:
+        if (!bookings.cancel(index, record.bookingId)) return false;
+        seatInventory.release(index, 1);
+        return true;
+    default:
+        return false;
+    }
+}
@@ -1,9 +1,67 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <pybind11/numpy.h>
 #include "../cpp/fms.h"
 
 namespace py = pybind11;
 
+// FlightCode / AirportCode cross the boundary as Python str. Text that does
+// not fit the packed width is rejected like any other wrong argument type.
+namespace pybind11 { namespace detail {
+template <int Words>
+struct type_caster<PackedCode<Words>> {
+    PYBIND11_TYPE_CASTER(PackedCode<Words>, const_name("str"));
+
+    bool load(handle src, bool) {
+        if (!isinstance<str>(src)) return false;
+        return PackedCode<Words>::parse(src.cast<std::string>(), value);
+    }
+
+    static handle cast(const PackedCode<Words>& code, return_value_policy, handle) {
+        return str(code.str()).release();
+    }
+};
+}}
+
+// Read-only n x n NumPy view of DistanceMatrix storage. The capsule owns a
+// reference to the storage, so the array stays valid after the matrix is
+// resized; rows refreshed in place show up in existing views.
+static py::array_t<int32_t> matrixView(const std::shared_ptr<int32_t>& storage, int n, int stride) {
+    auto* owner = new std::shared_ptr<int32_t>(storage);
+    py::capsule base(owner, [](void* p) { delete static_cast<std::shared_ptr<int32_t>*>(p); });
+    py::array_t<int32_t> view({n, n}, {static_cast<py::ssize_t>(stride) * sizeof(int32_t), sizeof(int32_t)},
+                              storage.get(), base);
+    view.attr("flags").attr("writeable") = false;
+    return view;
+}
+
+// Runs an AirportGraph traversal with an optional Python visitor, which gets
+// (airport name, depth) and stops the traversal by returning False.
+template <class Traversal>
+static std::vector<AirportCode> traversal(AirportGraph& g, AirportCode start, int maxDepth, const py::object& visit,
+                                          Traversal method) {
+    std::vector<int> order;
+    AirportGraph::TraversalVisitor visitor;
+    if (!visit.is_none()) {
+        visitor = [&](int airport, int depth) {
+            py::object keepGoing = visit(g.airportAt(airport), depth);
+            return keepGoing.is_none() || keepGoing.cast<bool>();
+        };
+    }
+    (g.*method)(start, order, maxDepth, visitor);
+    std::vector<AirportCode> codes;
+    codes.reserve(order.size());
+    for (int u : order) codes.push_back(g.airportAt(u));
+    return codes;
+}
+
+// (total weight, [(from, to, distance)]) for a spanning forest.
+static py::tuple forestTuple(const SpanningForest& forest) {
+    py::list edges;
+    for (const SpanningEdge& e : forest.edges) edges.append(py::make_tuple(e.from, e.to, e.distance));
+    return py::make_tuple(forest.weight, edges);
+}
+
 PYBIND11_MODULE(flight_fms_cpp, m) {
     m.doc() = "pybind11 bindings for Flight Management System (FMS)";
 
@@ -20,11 +78,16 @@ PYBIND11_MODULE(flight_fms_cpp, m) {
         .def_readwrite("source", &Flight::source)
         .def_readwrite("destination", &Flight::destination)
         .def_readwrite("distance", &Flight::distance)
-        .def_readwrite("seats", &Flight::seats)
-        .def_readwrite("active", &Flight::active)
-        .def_readonly("bookingHead", &Flight::bookingHead)
+        .def_property("seats",
+            [](const Flight &f) { return f.seats.load(); },
+            [](Flight &f, int seats) { f.seats.store(seats); })
+        .def_property("active",
+            [](const Flight &f) { return f.active.load(); },
+            [](Flight &f, bool active) { f.active.store(active); })
+        .def_readwrite("departureTime", &Flight::departureTime)
+        .def_readwrite("arrivalTime", &Flight::arrivalTime)
         .def("__repr__", [](const Flight &f){
-            return "<Flight id='" + f.flightID + "' " + f.source + "->" + f.destination + " seats=" + std::to_string(f.seats) + ">";
+            return "<Flight id='" + f.flightID.str() + "' " + f.source.str() + "->" + f.destination.str() + " seats=" + std::to_string(f.seats.load()) + ">";
         });
 
     py::class_<FlightBSTNode>(m, "FlightBSTNode")
@@ -40,15 +103,133 @@ PYBIND11_MODULE(flight_fms_cpp, m) {
         .def("search", &FlightBST::search, "Search a flight by id and return Flight*")
         .def("displayInOrder", &FlightBST::displayInOrder, "Print flights in-order (to stdout)");
 
+    py::enum_<RouteMode>(m, "RouteMode")
+        .value("FULL", ROUTE_FULL)
+        .value("EARLY_EXIT", ROUTE_EARLY_EXIT)
+        .value("BIDIRECTIONAL", ROUTE_BIDIRECTIONAL)
+        .value("ASTAR", ROUTE_ASTAR)
+        .value("AUTO", ROUTE_AUTO)
+        .value("CONTRACTED", ROUTE_CONTRACTED);
+
+    py::enum_<LogDurability>(m, "LogDurability")
+        .value("BUFFERED", LOG_BUFFERED)
+        .value("WRITTEN", LOG_WRITTEN)
+        .value("SYNCED", LOG_SYNCED);
+
+    py::class_<LogStats>(m, "LogStats")
+        .def_readonly("records", &LogStats::records)
+        .def_readonly("bytes", &LogStats::bytes)
+        .def_readonly("writes", &LogStats::writes)
+        .def_readonly("syncs", &LogStats::syncs)
+        .def("__repr__", [](const LogStats &s) {
+            return "<LogStats records=" + std::to_string(s.records) + " syncs=" + std::to_string(s.syncs) + ">";
+        });
+
+    py::class_<LoadError>(m, "LoadError")
+        .def_readonly("line", &LoadError::line)
+        .def_readonly("reason", &LoadError::reason)
+        .def("__repr__", [](const LoadError &e) {
+            return "<LoadError line=" + std::to_string(e.line) + " reason='" + e.reason + "'>";
+        });
+
+    py::class_<LoadReport>(m, "LoadReport")
+        .def_readonly("opened", &LoadReport::opened)
+        .def_readonly("loaded", &LoadReport::loaded)
+        .def_readonly("rejected", &LoadReport::rejected)
+        .def_readonly("errors", &LoadReport::errors)
+        .def("__repr__", [](const LoadReport &r) {
+            return "<LoadReport loaded=" + std::to_string(r.loaded) + " rejected=" + std::to_string(r.rejected) + ">";
+        });
+
+    // AirportGraph has no lock of its own and rebuilds its CSR lazily on
+    // queries, so its methods keep the GIL; FlightSystem's wrappers take
+    // graphMutex and release it.
     py::class_<AirportGraph>(m, "AirportGraph")
         .def(py::init<>())
         .def("getAirportIndex", &AirportGraph::getAirportIndex, "Get or create index for airport", py::arg("name"))
-        .def("addEdge", &AirportGraph::addEdge, "Add undirected edge between airports", py::arg("src"), py::arg("dest"), py::arg("dist"))
+        .def("addEdge", &AirportGraph::addEdge, "Add a flight's distance to the undirected route between airports", py::arg("src"), py::arg("dest"), py::arg("dist"))
+        .def("removeEdge", &AirportGraph::removeEdge, "Withdraw a flight's distance from its route; False if it was not there",
+             py::arg("src"), py::arg("dest"), py::arg("dist"))
+        .def("airportCount", &AirportGraph::airportCount)
+        .def("routeCount", &AirportGraph::routeCount, "Number of distinct airport pairs with an active flight")
         .def("DFS", &AirportGraph::DFS, "Depth-first traversal from start airport", py::arg("start"))
         .def("BFS", &AirportGraph::BFS, "Breadth-first traversal from start airport", py::arg("start"))
+        .def("depthFirst", [](AirportGraph& g, AirportCode start, int maxDepth, py::object visit) {
+                 return traversal(g, start, maxDepth, visit, &AirportGraph::depthFirst);
+             }, "Return airports in depth-first order; visit(airport, depth) may return False to stop",
+             py::arg("start"), py::arg("maxDepth") = -1, py::arg("visit") = py::none())
+        .def("breadthFirst", [](AirportGraph& g, AirportCode start, int maxDepth, py::object visit) {
+                 return traversal(g, start, maxDepth, visit, &AirportGraph::breadthFirst);
+             }, "Return airports in breadth-first order; visit(airport, depth) may return False to stop",
+             py::arg("start"), py::arg("maxDepth") = -1, py::arg("visit") = py::none())
+        .def("reachableFrom", [](AirportGraph& g, AirportCode start, int maxDepth) {
+                 std::vector<int> depth;
+                 g.reachableFrom(start, depth, maxDepth);
+                 py::dict out;
+                 for (size_t u = 0; u < depth.size(); ++u) {
+                     if (depth[u] >= 0) out[py::str(g.airportAt(static_cast<int>(u)).str())] = depth[u];
+                 }
+                 return out;
+             }, "Return {airport: routes from start} for every reachable airport (direction-optimizing BFS)",
+             py::arg("start"), py::arg("maxDepth") = -1)
         .def("dijkstra", &AirportGraph::dijkstra, "Compute shortest path (Dijkstra) between source and dest", py::arg("source"), py::arg("dest"))
         .def("primMST", &AirportGraph::primMST, "Run Prim's MST starting from given airport", py::arg("start"))
-        .def("kruskalMST", &AirportGraph::kruskalMST, "Run Kruskal's MST on the graph");
+        .def("kruskalMST", &AirportGraph::kruskalMST, "Run Kruskal's MST on the graph")
+        .def("connected", &AirportGraph::connected, "True if some chain of routes links the two airports",
+             py::arg("a"), py::arg("b"))
+        .def("componentSize", &AirportGraph::componentSize, "Number of airports connected to this one, itself included (0 if unknown)",
+             py::arg("airport"))
+        .def("componentCount", &AirportGraph::componentCount, "Number of connected components")
+        .def("components", &AirportGraph::components, "Return every connected component as a list of airports")
+        .def("primTree", [](AirportGraph& g, AirportCode start) {
+                 SpanningForest tree = g.primTree(start);
+                 return forestTuple(tree);
+             }, "Return (weight, [(from, to, distance)]) for the minimum spanning tree of start's part of the network",
+             py::arg("start"))
+        .def("kruskalForest", [](AirportGraph& g, int threads) {
+                 SpanningForest forest = g.kruskalForest(threads);
+                 return forestTuple(forest);
+             }, "Return (weight, [(from, to, distance)]) for the minimum spanning forest; parallel edge sort (threads=0: all cores)",
+             py::arg("threads") = 0)
+        .def("boruvkaForest", [](AirportGraph& g, int threads) {
+                 SpanningForest forest = g.boruvkaForest(threads);
+                 return forestTuple(forest);
+             }, "Return the same forest as kruskalForest, computed by parallel Boruvka (threads=0: all cores)",
+             py::arg("threads") = 0)
+        .def("setAirportCoordinates", &AirportGraph::setAirportCoordinates, "Set an airport's latitude/longitude in degrees (enables A*)",
+             py::arg("name"), py::arg("latitude"), py::arg("longitude"))
+        .def("version", &AirportGraph::version, "Counter bumped by every airport, route or weight change")
+        .def("buildHierarchy", &AirportGraph::buildHierarchy, "Build the contraction hierarchy used by RouteMode.CONTRACTED")
+        .def("hierarchyCurrent", &AirportGraph::hierarchyCurrent, "True if the hierarchy matches the current graph")
+        .def("shortestPath", [](AirportGraph& g, AirportCode source, AirportCode dest, RouteMode mode) {
+                 RouteStats stats;
+                 auto route = g.shortestPath(source, dest, mode, &stats);
+                 return py::make_tuple(route.first, route.second, stats.settled);
+             }, "Return (distance, path, settled airports); distance is INT_MAX if unreachable",
+             py::arg("source"), py::arg("dest"), py::arg("mode") = ROUTE_AUTO)
+        .def("kShortestPaths", [](AirportGraph& g, AirportCode source, AirportCode dest, int k, int maxLegs,
+                                  const std::vector<AirportCode>& excluded) {
+                 std::vector<Itinerary> itineraries = g.kShortestPaths(source, dest, k, maxLegs, excluded);
+                 py::list out;
+                 for (const Itinerary& it : itineraries) out.append(py::make_tuple(it.distance, it.airports));
+                 return out;
+             }, "Return up to k loopless routes [(distance, path)], shortest first; maxLegs=0 means no limit",
+             py::arg("source"), py::arg("dest"), py::arg("k"), py::arg("maxLegs") = 0,
+             py::arg("excluded") = std::vector<AirportCode>())
+        .def("computeAllPairs", &AirportGraph::computeAllPairs, "Compute the all-pairs distance matrix (threads=0: all cores)",
+             py::arg("threads") = 0)
+        .def("refreshAllPairs", &AirportGraph::refreshAllPairs,
+             "Recompute the matrix rows affected by changes since the last computation; returns how many",
+             py::arg("threads") = 0)
+        .def("allPairsCurrent", &AirportGraph::allPairsCurrent, "True if the matrix matches the current graph")
+        .def("distanceMatrix", [](const AirportGraph& g) {
+                 const DistanceMatrix& d = g.allPairs();
+                 return matrixView(d.distanceStorage(), d.size(), d.stride());
+             }, "Read-only int32 array of distances by airport index (INT32_MAX if unreachable); no copy")
+        .def("nextHopMatrix", [](const AirportGraph& g) {
+                 const DistanceMatrix& d = g.allPairs();
+                 return matrixView(d.nextHopStorage(), d.size(), d.stride());
+             }, "Read-only int32 array of the first airport index on each shortest path (-1 if none); no copy");
 
     py::class_<FlightSystem>(m, "FlightSystem")
         .def(py::init<>())
@@ -63,13 +244,134 @@ PYBIND11_MODULE(flight_fms_cpp, m) {
         .def("showBookingsForFlight", &FlightSystem::showBookingsForFlight, "Interactive: show bookings for a flight (reads flight id from stdin)")
 
         .def("searchFlightsBySource", &FlightSystem::searchFlightsBySource, "Interactive: search flights by source (reads source from stdin)")
-        .def("showRecentSearches", &FlightSystem::showRecentSearches, "Print recent search stack")
+        .def("showRecentSearches", &FlightSystem::showRecentSearches, "Print recently searched sources with their search counts")
 
         .def("shortestDistanceBetweenAirports", &FlightSystem::shortestDistanceBetweenAirports, "Interactive: Dijkstra (reads source/dest from stdin)")
         .def("runDFS", &FlightSystem::runDFS, "Interactive: DFS (reads start from stdin)")
         .def("runBFS", &FlightSystem::runBFS, "Interactive: BFS (reads start from stdin)")
         .def("runPrimMST", &FlightSystem::runPrimMST, "Interactive: Prim's MST (reads start from stdin)")
-        .def("runKruskalMST", &FlightSystem::runKruskalMST, "Run Kruskal's MST (non-interactive)");
+        .def("runKruskalMST", &FlightSystem::runKruskalMST, "Run Kruskal's MST (non-interactive)")
+
+        .def("addFlightParams", &FlightSystem::addFlightParams,
+             "Add a flight, optionally with departure/arrival times in Unix seconds; returns False if the ID is empty or already exists",
+             py::arg("flightID"), py::arg("source"), py::arg("destination"), py::arg("distance"), py::arg("seats"),
+             py::arg("departureTime") = 0, py::arg("arrivalTime") = 0, py::call_guard<py::gil_scoped_release>())
+        .def("cancelFlightById", &FlightSystem::cancelFlightById, "Mark a flight cancelled; False if it is unknown",
+             py::arg("flightID"), py::call_guard<py::gil_scoped_release>())
+        .def("scheduleFlightById", &FlightSystem::scheduleFlightById, "Mark a flight active again; False if it is unknown",
+             py::arg("flightID"), py::call_guard<py::gil_scoped_release>())
+        .def("listFlights", &FlightSystem::listFlights, "Return copies of all stored flights")
+        .def("queueBooking", &FlightSystem::queueBooking,
+             "Queue a booking request; returns False if the flight is unknown or inactive or the queue is full. Releases the GIL",
+             py::arg("flightID"), py::arg("passengerName"), py::call_guard<py::gil_scoped_release>())
+        .def("startBookingWorker", &FlightSystem::startBookingWorker, "Confirm queued bookings on a background thread")
+        .def("stopBookingWorker", &FlightSystem::stopBookingWorker, "Drain the queue and stop the booking worker",
+             py::call_guard<py::gil_scoped_release>())
+        .def("bookingWorkerRunning", &FlightSystem::bookingWorkerRunning)
+        .def("processNextBookingNonInteractive", &FlightSystem::processNextBookingNonInteractive,
+             "Confirm the next queued booking; an empty name keeps the name given to queueBooking. Returns (ok, message)",
+             py::arg("passengerName") = std::string(""), py::call_guard<py::gil_scoped_release>())
+        .def("bookBatch", &FlightSystem::bookBatch,
+             "Confirm [(flightID, passengerName)] in one call; returns a booking ID or negative BOOKING_* code per request. Releases the GIL",
+             py::arg("requests"), py::call_guard<py::gil_scoped_release>())
+        .def("cancelBookingById", &FlightSystem::cancelBookingById, "Cancel a booking and restore its seat",
+             py::arg("flightID"), py::arg("bookingId"), py::call_guard<py::gil_scoped_release>())
+        .def("getBookingsForFlight", &FlightSystem::getBookingsForFlight, "Return [(bookingId, passengerName)] for a flight",
+             py::arg("flightID"))
+        .def("searchFlightsBySourceNonInteractive", &FlightSystem::searchFlightsBySourceNonInteractive,
+             "Return active flights leaving source, in the order they were added", py::arg("source"))
+        .def("recentSearchesList", &FlightSystem::recentSearchesList, "Recently searched sources, most recent first")
+        .def("topSearches", &FlightSystem::topSearches, "Return [(source, count)] for the k most searched sources",
+             py::arg("k") = 10)
+        .def("searchFlightsByRoute", &FlightSystem::searchFlightsByRouteList,
+             "Return active flights from source to destination", py::arg("source"), py::arg("destination"))
+        .def("flightsToDestination", &FlightSystem::flightsToDestinationList,
+             "Return active flights arriving at destination", py::arg("destination"))
+        .def("dijkstraPath", &FlightSystem::dijkstraPath, "Return (distance, [airports]) for the shortest route",
+             py::arg("src"), py::arg("dest"), py::arg("mode") = ROUTE_AUTO)
+        .def("dfsOrder", &FlightSystem::dfsOrder, "Return airports in depth-first order from start (maxDepth=-1: no limit)",
+             py::arg("start"), py::arg("maxDepth") = -1)
+        .def("bfsOrder", &FlightSystem::bfsOrder, "Return airports in breadth-first order from start (maxDepth=-1: no limit)",
+             py::arg("start"), py::arg("maxDepth") = -1)
+        .def("reachableAirports", &FlightSystem::reachableAirports,
+             "Return [(airport, routes from start)] for every airport reachable from start",
+             py::arg("start"), py::arg("maxDepth") = -1, py::call_guard<py::gil_scoped_release>())
+        .def("airportsConnected", &FlightSystem::airportsConnected, "True if some chain of active flights links the two airports",
+             py::arg("a"), py::arg("b"))
+        .def("componentSize", &FlightSystem::componentSize, "Number of airports connected to this one, itself included",
+             py::arg("airport"))
+        .def("connectedComponents", &FlightSystem::connectedComponents, "Return every connected component as a list of airports")
+        .def("saveSnapshot", &FlightSystem::saveSnapshot,
+             "Write the system to a binary snapshot file, replacing it atomically. Releases the GIL",
+             py::arg("path"), py::call_guard<py::gil_scoped_release>())
+        .def("loadSnapshot", &FlightSystem::loadSnapshot,
+             "Replace the system with a snapshot file's contents; False (state unchanged) if it is unreadable. Releases the GIL",
+             py::arg("path"), py::call_guard<py::gil_scoped_release>())
+        .def("openLog", &FlightSystem::openLog,
+             "Replay a write-ahead log on top of the current state, then log every mutation to it; returns the number "
+             "of records replayed, or -1. Releases the GIL",
+             py::arg("path"), py::arg("durability") = LOG_SYNCED, py::arg("groupCommitMicros") = 0,
+             py::call_guard<py::gil_scoped_release>())
+        .def("closeLog", &FlightSystem::closeLog, "Sync and close the write-ahead log", py::call_guard<py::gil_scoped_release>())
+        .def("flushLog", &FlightSystem::flushLog, "Write and sync everything logged so far", py::call_guard<py::gil_scoped_release>())
+        .def("checkpoint", &FlightSystem::checkpoint,
+             "Save a snapshot and drop the log records it holds. Releases the GIL",
+             py::arg("snapshotPath"), py::call_guard<py::gil_scoped_release>())
+        .def("logStats", &FlightSystem::logStats, "Records, bytes, writes and syncs since the log was opened")
+        .def("logHealthy", &FlightSystem::logHealthy, "False once a log write or sync has failed")
+        .def("loadFlightsCsv", &FlightSystem::loadFlightsCsv,
+             "Bulk load flightID,source,destination,distance,seats,active rows from a flights file in parallel; "
+             "returns a LoadReport with the first rejected lines. Releases the GIL",
+             py::arg("path"), py::arg("threads") = 0, py::call_guard<py::gil_scoped_release>())
+        .def("minimumSpanningForest", &FlightSystem::minimumSpanningForest,
+             "Return the route network's minimum spanning forest as [(from, to, distance)], by ascending distance",
+             py::arg("threads") = 0, py::call_guard<py::gil_scoped_release>())
+        .def("alternativeRoutes", &FlightSystem::alternativeRoutes,
+             "Return up to k routes [(distance, [airports])], shortest first, with at most maxLegs flights (0 = any) "
+             "and avoiding the excluded airports. Releases the GIL",
+             py::arg("src"), py::arg("dest"), py::arg("k") = 10, py::arg("maxLegs") = 0,
+             py::arg("excluded") = std::vector<std::string>(), py::call_guard<py::gil_scoped_release>())
+        .def("earliestArrival", &FlightSystem::earliestArrival,
+             "Return (arrival time, [flightIDs]) for the earliest arrival leaving src at or after departAfter; (-1, []) if none. "
+             "Releases the GIL",
+             py::arg("src"), py::arg("dest"), py::arg("departAfter"), py::call_guard<py::gil_scoped_release>())
+        .def("setDefaultConnectionTime", &FlightSystem::setDefaultConnectionTime,
+             "Minimum seconds between arriving and departing again at airports without their own setting", py::arg("seconds"))
+        .def("setMinimumConnectionTime", &FlightSystem::setMinimumConnectionTime,
+             "Minimum seconds between arriving and departing again at one airport", py::arg("airport"), py::arg("seconds"))
+        .def("publishSchedule", &FlightSystem::publishSchedule,
+             "Rebuild the route index if the network changed; returns True if it rebuilt",
+             py::call_guard<py::gil_scoped_release>())
+        .def("setAirportCoordinates", &FlightSystem::setAirportCoordinates, "Set an airport's latitude/longitude in degrees (enables A*)",
+             py::arg("airport"), py::arg("latitude"), py::arg("longitude"))
+        .def("computeDistanceMatrix", &FlightSystem::computeDistanceMatrix, "Compute the all-pairs distance matrix (threads=0: all cores)",
+             py::arg("threads") = 0, py::call_guard<py::gil_scoped_release>())
+        .def("refreshDistanceMatrix", &FlightSystem::refreshDistanceMatrix,
+             "Recompute the matrix rows affected by route changes; returns how many",
+             py::arg("threads") = 0, py::call_guard<py::gil_scoped_release>())
+        .def("distanceMatrix", [](const FlightSystem& fs) {
+                 DistanceMatrix d = fs.distanceMatrix();
+                 return matrixView(d.distanceStorage(), d.size(), d.stride());
+             }, "Read-only int32 array of distances, rows/columns in matrixAirports() order; no copy")
+        .def("nextHopMatrix", [](const FlightSystem& fs) {
+                 DistanceMatrix d = fs.distanceMatrix();
+                 return matrixView(d.nextHopStorage(), d.size(), d.stride());
+             }, "Read-only int32 array of next-hop indices into matrixAirports() (-1 if none); no copy")
+        .def("matrixAirports", &FlightSystem::matrixAirports, "Airport names in distance matrix order")
+        .def("availableSeats", &FlightSystem::availableSeats, "Seats left on a flight (-1 if unknown); never blocks",
+             py::arg("flightID"))
+        .def("holdSeats", &FlightSystem::holdSeats, "Hold seats for ttlMillis; returns a hold ID, or 0 if not enough seats",
+             py::arg("flightID"), py::arg("count"), py::arg("ttlMillis"), py::call_guard<py::gil_scoped_release>())
+        .def("confirmHoldBooking", &FlightSystem::confirmHoldBooking,
+             "Book one passenger per held seat; returns the booking IDs, or [] if the hold expired or the flight was cancelled. "
+             "A name count other than the hold size returns [] and keeps the hold",
+             py::arg("holdId"), py::arg("passengerNames"), py::call_guard<py::gil_scoped_release>())
+        .def("releaseHold", &FlightSystem::releaseHold, "Give a hold's seats back", py::arg("holdId"))
+        .def("expireHolds", &FlightSystem::expireHolds, "Release every expired hold; returns the number of seats freed");
+
+    m.attr("BOOKING_FLIGHT_NOT_FOUND") = static_cast<int>(BOOKING_FLIGHT_NOT_FOUND);
+    m.attr("BOOKING_FLIGHT_INACTIVE") = static_cast<int>(BOOKING_FLIGHT_INACTIVE);
+    m.attr("BOOKING_SOLD_OUT") = static_cast<int>(BOOKING_SOLD_OUT);
 
     m.attr("__doc__") = "Bindings expose core FMS types; many methods are still interactive and use stdin/stdout. "
                         "If you want non-interactive wrappers (recommended for Streamlit), ask me to add parameterized wrapper methods next.";
@@ -2,6 +2,7 @@ from setuptools import setup, Extension
 import pybind11
 import sysconfig
 import os
+import glob
 
 pybind_includes = pybind11.get_include()
 pybind_user_includes = pybind11.get_include(user=True)
@@ -17,13 +18,19 @@ include_dirs = [
     os.path.abspath("../cpp"),
 ]
 
+core_sources = sorted(
+    src for src in glob.glob("../cpp/*.cpp")
+    if os.path.basename(src) != "FMS.cpp"
+)
+
 ext_modules = [
     Extension(
         "flight_fms_cpp",
-        sources=["bindings.cpp", "../cpp/fms_core.cpp"],
+        sources=["bindings.cpp"] + core_sources,
         include_dirs=include_dirs,
         language="c++",
-        extra_compile_args=["-std=c++17", "-O3"],
+        extra_compile_args=["-std=c++17", "-O3", "-pthread"],
+        extra_link_args=["-pthread"],
     )
 ]
 